@@ -0,0 +1,6 @@
+BENCH_LIST = $(sort $(patsubst %/bench.mk,%, $(shell find $(ROOT_DIR)tests -type f -name bench.mk)))
+# Benchmarks with a bench.mk are built on the test fixture, like full tests
+FULL_TESTS := $(notdir $(BENCH_LIST))
+
+include $(QUANTUM_PATH)/debounce/tests/testlist.mk
+BENCH_LIST += $(DEBOUNCE_BENCH_LIST)
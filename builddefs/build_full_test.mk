@@ -13,6 +13,14 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+# Lets idle_for() and the trace replay jump the clock straight to the next deadline
+ifeq ($(strip $(TEST_VIRTUAL_CLOCK)), yes)
+    OPT_DEFS += -DTEST_VIRTUAL_CLOCK
+    ifneq ($(strip $(TICKLESS_IDLE_ENABLE)), yes)
+        QUANTUM_SRC += $(QUANTUM_DIR)/deadline.c
+    endif
+endif
+
 $(TEST)_INC := \
 	tests/test_common/common_config.h
 
@@ -27,6 +35,7 @@ $(TEST)_SRC := \
 	tests/test_common/test_fixture.cpp \
 	tests/test_common/test_keymap_key.cpp \
 	tests/test_common/test_logger.cpp \
+	tests/test_common/test_trace_replay.cpp \
 	$(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
 
 $(TEST)_DEFS := $(TMK_COMMON_DEFS) $(OPT_DEFS)
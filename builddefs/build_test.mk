@@ -46,6 +46,7 @@ all: elf
 PLATFORM:=TEST
 PLATFORM_KEY:=test
 BOOTLOADER_TYPE:=none
+OPT_DEFS += -DPROTOCOL_TEST
 
 ifeq ($(strip $(DEBUG)), 1)
 CONSOLE_ENABLE = yes
@@ -53,7 +54,8 @@ endif
 
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include tests/test_common/build.mk
-include $(TEST_PATH)/test.mk
+# Benchmarks are marked with a bench.mk instead of a test.mk, to keep them out of test:all
+include $(wildcard $(TEST_PATH)/test.mk $(TEST_PATH)/bench.mk)
 endif
 
 include $(BUILDDEFS_PATH)/common_features.mk
@@ -61,8 +63,12 @@ include $(BUILDDEFS_PATH)/generic_features.mk
 include $(PLATFORM_PATH)/common.mk
 include $(TMK_PATH)/protocol.mk
 include $(QUANTUM_PATH)/debounce/tests/rules.mk
+include $(QUANTUM_PATH)/dynamic_keymap/tests/rules.mk
 include $(QUANTUM_PATH)/encoder/tests/rules.mk
+include $(QUANTUM_PATH)/key_event_queue/tests/rules.mk
+include $(QUANTUM_PATH)/matrix_port/tests/rules.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
+include $(QUANTUM_PATH)/task_scheduler/tests/rules.mk
 include $(QUANTUM_PATH)/wear_leveling/tests/rules.mk
 include $(QUANTUM_PATH)/logging/print.mk
 include $(PLATFORM_PATH)/test/rules.mk
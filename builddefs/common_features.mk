@@ -44,6 +44,45 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+# Has to come before tmk_core/protocol.mk, which turns CONSOLE_ENABLE into the console endpoint and define
+ifeq ($(strip $(PROFILE_ENABLE)), yes)
+    ifeq ($(origin CONSOLE_ENABLE), command line)
+        ifneq ($(strip $(CONSOLE_ENABLE)), yes)
+            $(call CATASTROPHIC_ERROR,Invalid CONSOLE_ENABLE,PROFILE_ENABLE prints its timings to the console and requires CONSOLE_ENABLE)
+        endif
+    endif
+    OPT_DEFS += -DPROFILE_ENABLE
+    CONSOLE_ENABLE = yes
+endif
+
+# The latency tracer times its stages with the profile counter
+ifneq ($(filter yes,$(strip $(PROFILE_ENABLE)) $(strip $(LATENCY_TRACE_ENABLE))),)
+    QUANTUM_SRC += $(QUANTUM_DIR)/profile.c
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/profile.c)
+endif
+
+ifeq ($(strip $(TICKLESS_IDLE_ENABLE)), yes)
+    OPT_DEFS += -DTICKLESS_IDLE_ENABLE
+    TASK_SCHEDULER_ENABLE = yes
+    QUANTUM_SRC += $(QUANTUM_DIR)/deadline.c $(QUANTUM_DIR)/tickless_idle.c
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/tickless_idle.c)
+    ifeq ($(PLATFORM_KEY),chibios)
+        OPT_DEFS += -DCORTEX_ENABLE_WFI_IDLE=TRUE
+    endif
+endif
+
+ifeq ($(strip $(BACKGROUND_MATRIX_SCAN_ENABLE)), yes)
+    OPT_DEFS += -DBACKGROUND_MATRIX_SCAN_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/background_matrix_scan.c \
+                   $(QUANTUM_DIR)/key_event_queue.c
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/background_matrix_scan.c)
+endif
+
+ifeq ($(strip $(KEYMAP_CACHE_ENABLE)), yes)
+    OPT_DEFS += -DKEYMAP_CACHE_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/keymap_cache.c
+endif
+
 AUDIO_ENABLE ?= no
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),CHIBIOS)
@@ -639,6 +678,7 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
 
     # Include common stuff for all non custom matrix users
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix_common.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/matrix_port.c
 
     # if 'lite' then skip the actual matrix implementation
     ifneq ($(strip $(CUSTOM_MATRIX)), lite)
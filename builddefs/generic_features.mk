@@ -29,12 +29,16 @@ GENERIC_FEATURES = \
     HAPTIC \
     KEY_LOCK \
     KEY_OVERRIDE \
+    KEYSTROKE_TRACE \
+    LATENCY_TRACE \
     LEADER \
     PROGRAMMABLE_BUTTON \
     SECURE \
+    SOF_SYNC \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_SCHEDULER \
     VELOCIKEY \
     WPM \
     DYNAMIC_TAPPING_TERM \
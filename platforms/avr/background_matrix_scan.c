@@ -0,0 +1,36 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdbool.h>
+#include "timer_avr.h"
+#include "background_matrix_scan.h"
+
+#if !defined(TIMSK0) || !defined(OCR0B)
+#    error "Background matrix scanning is not supported on this MCU"
+#endif
+
+// Scans are driven by the millisecond timer, so the interval is rounded down to whole milliseconds
+#define SCAN_INTERVAL_MS (BACKGROUND_MATRIX_SCAN_INTERVAL_US >= 2000 ? BACKGROUND_MATRIX_SCAN_INTERVAL_US / 1000 : 1)
+
+void background_matrix_scan_start(void) {
+    // Compare match B of the millisecond timer, half a period away from the timer tick itself
+    OCR0B = TIMER_RAW_TOP / 2;
+    TIFR0 = _BV(OCF0B);
+    TIMSK0 |= _BV(OCIE0B);
+}
+
+// Interrupts stay enabled while scanning, so neither the timer tick nor USB are held up by the matrix delays
+ISR(TIMER0_COMPB_vect, ISR_NOBLOCK) {
+    static uint16_t      ticks    = 0;
+    static volatile bool scanning = false;
+
+    if (++ticks < SCAN_INTERVAL_MS || scanning) {
+        return;
+    }
+    ticks    = 0;
+    scanning = true;
+    background_matrix_scan_task();
+    scanning = false;
+}
@@ -36,3 +36,11 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Operation of GPIO by port, where a port is identified by any of its pins. */
+
+typedef uint8_t pin_port_data_t;
+
+#define readPinPort(pin) (PINx_ADDRESS(pin))
+#define getPinPad(pin) ((pin)&0xF)
+#define isSamePort(pin_a, pin_b) (((pin_a) >> PORT_SHIFTER) == ((pin_b) >> PORT_SHIFTER))
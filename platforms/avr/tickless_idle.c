@@ -0,0 +1,33 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "tickless_idle.h"
+
+static volatile bool wake_requested = false;
+
+void tickless_idle_sleep(uint32_t ms) {
+    const uint32_t start = timer_read32();
+
+    // The millisecond timer interrupt wakes the core up, as does USB activity
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (timer_elapsed32(start) < ms) {
+        cli();
+        if (wake_requested) {
+            sei();
+            break;
+        }
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    wake_requested = false;
+}
+
+void tickless_idle_wake(void) {
+    wake_requested = true;
+}
@@ -0,0 +1,32 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+
+#include "background_matrix_scan.h"
+
+#ifndef BACKGROUND_MATRIX_SCAN_THREAD_PRIORITY
+#    define BACKGROUND_MATRIX_SCAN_THREAD_PRIORITY HIGHPRIO
+#endif
+
+/**
+ * @brief This thread scans the matrix at a fixed rate, preempting the main
+ * loop whenever a scan is due.
+ */
+static THD_WORKING_AREA(waMatrixScanThread, 256);
+static THD_FUNCTION(MatrixScanThread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix_scan");
+
+    systime_t next = chVTGetSystemTime();
+    while (true) {
+        background_matrix_scan_task();
+
+        /* Sleep until the next scan is due, keeping the rate steady however long the scan took. */
+        next = chThdSleepUntilWindowed(next, chTimeAddX(next, TIME_US2I(BACKGROUND_MATRIX_SCAN_INTERVAL_US)));
+    }
+}
+
+void background_matrix_scan_start(void) {
+    chThdCreateStatic(waMatrixScanThread, sizeof(waMatrixScanThread), BACKGROUND_MATRIX_SCAN_THREAD_PRIORITY, MatrixScanThread, NULL);
+}
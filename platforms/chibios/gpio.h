@@ -43,3 +43,11 @@ typedef ioline_t pin_t;
 #define readPin(pin) palReadLine(pin)
 
 #define togglePin(pin) palToggleLine(pin)
+
+/* Operation of GPIO by port, where a port is identified by any of its pins. */
+
+typedef ioportmask_t pin_port_data_t;
+
+#define readPinPort(pin) palReadPort(PAL_PORT(pin))
+#define getPinPad(pin) PAL_PAD(pin)
+#define isSamePort(pin_a, pin_b) (PAL_PORT(pin_a) == PAL_PORT(pin_b))
@@ -0,0 +1,18 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <hal.h>
+#include "profile.h"
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+// Cortex-M3 and above provide a free-running CPU cycle counter in the DWT unit
+void profile_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t profile_timestamp(void) {
+    return DWT->CYCCNT;
+}
+#endif
@@ -0,0 +1,20 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include "tickless_idle.h"
+
+static thread_reference_t sleeping_thread = NULL;
+
+void tickless_idle_sleep(uint32_t ms) {
+    // Suspending the main thread lets the idle thread halt the core until the timeout or a wake up
+    chSysLock();
+    chThdSuspendTimeoutS(&sleeping_thread, TIME_MS2I(ms));
+    chSysUnlock();
+}
+
+void tickless_idle_wake(void) {
+    chSysLockFromISR();
+    chThdResumeI(&sleeping_thread, MSG_OK);
+    chSysUnlockFromISR();
+}
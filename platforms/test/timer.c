@@ -15,6 +15,9 @@
  */
 
 #include "timer.h"
+#ifdef TEST_VIRTUAL_CLOCK
+#    include "deadline.h"
+#endif
 
 static uint32_t current_time = 0;
 
@@ -46,6 +49,29 @@ void advance_time(uint32_t ms) {
     current_time += ms;
 }
 
+/* The clock is virtual, so nothing happens between the deadlines reported by the core, and with TEST_VIRTUAL_CLOCK it
+ * jumps straight to the next one. Otherwise, or when the next deadline is already due, or when a feature polls without
+ * reporting a deadline, it moves on by 1ms. It never moves past `limit`, and does not move at all once `limit` is
+ * reached.
+ */
+void advance_time_to_next_deadline(uint32_t limit) {
+    if ((int32_t)TIMER_DIFF_32(limit, current_time) <= 0) {
+        return;
+    }
+
+    uint32_t next = current_time + 1;
+#ifdef TEST_VIRTUAL_CLOCK
+    const uint32_t deadline = next_deadline(TIMER_DIFF_32(limit, current_time));
+    if ((int32_t)TIMER_DIFF_32(deadline, next) > 0) {
+        next = deadline;
+    }
+#endif
+    if ((int32_t)TIMER_DIFF_32(next, limit) > 0) {
+        next = limit;
+    }
+    current_time = next;
+}
+
 void wait_ms(uint32_t ms) {
     advance_time(ms);
 }
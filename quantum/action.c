@@ -36,6 +36,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action.h"
 #include "wait.h"
 #include "keycode_config.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -279,6 +282,9 @@ void process_record_handler(keyrecord_t *record) {
     }
 #else
     action_t action = store_or_get_action(record->event.pressed, record->event.key);
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+    latency_trace_key_resolved(record, action);
 #endif
     dprint("ACTION: ");
     debug_action(action);
@@ -13,6 +13,10 @@
 #include "util.h"
 #include "action_layer.h"
 
+#ifdef KEYMAP_CACHE_ENABLE
+#    include "keymap_cache.h"
+#endif
+
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
@@ -328,10 +332,27 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef KEYMAP_CACHE_ENABLE
+    uint8_t layer;
+    if (keymap_cache_get_layer(key, &layer)) {
+        return layer;
+    }
+#    endif
+    return layer_switch_find_layer(key, layer_state | default_layer_state);
+#else
+    return get_highest_layer(default_layer_state);
+#endif
+}
+
+#ifndef NO_ACTION_LAYER
+/** \brief Layer switch find layer
+ *
+ * Searches the given layers for the topmost one where the key is not transparent
+ */
+uint8_t layer_switch_find_layer(keypos_t key, layer_state_t layers) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -343,10 +364,8 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
-#else
-    return get_highest_layer(default_layer_state);
-#endif
 }
+#endif
 
 /** \brief Layer switch get layer
  *
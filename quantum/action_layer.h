@@ -143,5 +143,10 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+#ifndef NO_ACTION_LAYER
+/* return the topmost non-transparent layer associated with key among the given layers */
+uint8_t layer_switch_find_layer(keypos_t key, layer_state_t layers);
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
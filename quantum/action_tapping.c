@@ -62,13 +62,24 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 #        include "process_auto_shift.h"
 #    endif
 
+#    if WAITING_BUFFER_SIZE < 2 || WAITING_BUFFER_SIZE > UINT8_MAX
+#        error "WAITING_BUFFER_SIZE must be between 2 and 255"
+#    endif
+
+// Advances a position in the waiting buffer ring without a division, which is costly on AVR
+#    define WAITING_BUFFER_NEXT(i) ((i) + 1 == WAITING_BUFFER_SIZE ? 0 : (i) + 1)
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+// Number of press and release events in the waiting buffer, so that searches for either can be skipped when there are none
+static uint8_t waiting_buffer_presses  = 0;
+static uint8_t waiting_buffer_releases = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(bool pressed);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -101,13 +112,16 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        // Processing may turn a press into a release, so remember what was queued
+        const bool pressed = waiting_buffer[waiting_buffer_tail].event.pressed;
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             debug("processed: waiting_buffer[");
             debug_dec(waiting_buffer_tail);
             debug("] = ");
             debug_record(waiting_buffer[waiting_buffer_tail]);
             debug("\n\n");
+            waiting_buffer_deq(pressed);
         } else {
             break;
         }
@@ -117,6 +131,28 @@ void action_tapping_process(keyrecord_t record) {
     }
 }
 
+/** \brief Next tapping deadline
+ *
+ * Reports when the pending tapping key reaches the end of its tapping term, which is then resolved by the next tick.
+ *
+ * \return true if a tapping key is waiting for its term to expire
+ */
+bool action_tapping_next_deadline(uint32_t *deadline) {
+    if (!IS_TAPPING()) {
+        return false;
+    }
+
+    const uint16_t term    = GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key);
+    const uint16_t elapsed = TIMER_DIFF_16(timer_read(), tapping_key.event.time);
+    if (elapsed >= term) {
+        return false;
+    }
+
+    // Event times have their lowest bit forced on, so the term can expire a millisecond early
+    *deadline = timer_read32() + (term - elapsed - 1);
+    return true;
+}
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -448,26 +484,50 @@ bool waiting_buffer_enq(keyrecord_t record) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = WAITING_BUFFER_NEXT(waiting_buffer_head);
+    if (record.event.pressed) {
+        waiting_buffer_presses++;
+    } else {
+        waiting_buffer_releases++;
+    }
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Drops the oldest event once it has been processed, pressed being whether it was queued as a press.
+ */
+void waiting_buffer_deq(bool pressed) {
+    if (waiting_buffer_tail == waiting_buffer_head) {
+        // cleared while the event was processed
+        return;
+    }
+    if (pressed) {
+        waiting_buffer_presses--;
+    } else {
+        waiting_buffer_releases--;
+    }
+    waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail);
+}
+
 /** \brief Waiting buffer clear
  *
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head     = 0;
+    waiting_buffer_tail     = 0;
+    waiting_buffer_presses  = 0;
+    waiting_buffer_releases = 0;
 }
 
 /** \brief Waiting buffer typed
@@ -475,7 +535,11 @@ void waiting_buffer_clear(void) {
  * FIXME: Needs docs
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    // Only an event of the opposite kind can complete the key
+    if ((event.pressed ? waiting_buffer_releases : waiting_buffer_presses) == 0) {
+        return false;
+    }
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -488,10 +552,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_presses > 0;
 }
 
 /** \brief Scan buffer for tapping
@@ -503,8 +564,10 @@ void waiting_buffer_scan_tap(void) {
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // the tapping key can not have been released yet
+    if (waiting_buffer_releases == 0) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
             tapping_key.tap.count       = 1;
             waiting_buffer[i].tap.count = 1;
@@ -535,7 +598,7 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         debug("[");
         debug_dec(i);
         debug("]=");
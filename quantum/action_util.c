@@ -437,6 +437,48 @@ void clear_oneshot_mods(void) {
         oneshot_mods_changed_kb(oneshot_mods);
     }
 }
+
+#    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
+static void oneshot_earliest_timeout(uint16_t start, uint16_t *remaining, bool *pending) {
+    uint16_t elapsed = TIMER_DIFF_16(timer_read(), start);
+    if (elapsed < ONESHOT_TIMEOUT && (!*pending || ONESHOT_TIMEOUT - elapsed < *remaining)) {
+        *remaining = ONESHOT_TIMEOUT - elapsed;
+        *pending   = true;
+    }
+}
+#    endif
+
+/** \brief Next one shot deadline
+ *
+ * Reports when the earliest active one shot modifier, layer or swap hands times out.
+ *
+ * \return true if a one shot is waiting for ONESHOT_TIMEOUT to expire
+ */
+bool oneshot_next_deadline(uint32_t *deadline) {
+#    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
+    uint16_t remaining = 0;
+    bool     pending   = false;
+
+    if (oneshot_mods) {
+        oneshot_earliest_timeout(oneshot_time, &remaining, &pending);
+    }
+    if (get_oneshot_layer_state() && !(get_oneshot_layer_state() & ONESHOT_TOGGLED)) {
+        oneshot_earliest_timeout(oneshot_layer_time, &remaining, &pending);
+    }
+#        ifdef SWAP_HANDS_ENABLE
+    if (swap_hands_oneshot == SHO_ACTIVE) {
+        oneshot_earliest_timeout(oneshot_swaphands_time, &remaining, &pending);
+    }
+#        endif
+
+    if (pending) {
+        *deadline = timer_read32() + remaining;
+    }
+    return pending;
+#    else
+    return false;
+#    endif
+}
 #endif
 
 /** \brief Called when the one shot modifiers have been changed.
@@ -0,0 +1,71 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "background_matrix_scan.h"
+#include "key_event_queue.h"
+#include "matrix.h"
+#include "timer.h"
+#ifdef TICKLESS_IDLE_ENABLE
+#    include "tickless_idle.h"
+#endif
+
+#ifdef SPLIT_KEYBOARD
+#    error "Background matrix scanning does not support split keyboards, as the transport runs on the main loop"
+#endif
+#ifdef MATRIX_HAS_GHOST
+#    error "Background matrix scanning does not support ghost detection"
+#endif
+
+static key_event_queue_t key_events;
+
+// Key states already queued as events, only touched by the scanning side
+static matrix_row_t matrix_queued[MATRIX_ROWS];
+
+// Platforms without a scan timer are driven externally, such as by the tests
+__attribute__((weak)) void background_matrix_scan_start(void) {}
+
+void background_matrix_scan_init(void) {
+    key_event_queue_init(&key_events);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_queued[row] = 0;
+    }
+    background_matrix_scan_start();
+}
+
+void background_matrix_scan_task(void) {
+    matrix_scan_keys();
+
+    bool queued = false;
+    bool full   = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS && !full; row++) {
+        const matrix_row_t current_row = matrix_get_row(row);
+        const matrix_row_t row_changes = current_row ^ matrix_queued[row];
+
+        matrix_row_t col_mask = 1;
+        for (uint8_t col = 0; col < MATRIX_COLS && row_changes; col++, col_mask <<= 1) {
+            if (row_changes & col_mask) {
+                const bool key_pressed = current_row & col_mask;
+
+                // Once the queue is full, leave the remaining changes for the next scan so none are lost
+                if (!key_event_queue_push(&key_events, MAKE_KEYEVENT(row, col, key_pressed))) {
+                    full = true;
+                    break;
+                }
+                matrix_queued[row] ^= col_mask;
+                queued = true;
+            }
+        }
+    }
+
+#ifdef TICKLESS_IDLE_ENABLE
+    if (queued) {
+        tickless_idle_wake();
+    }
+#else
+    (void)queued;
+#endif
+}
+
+bool background_matrix_scan_get_event(keyevent_t *event) {
+    return key_event_queue_pop(&key_events, event);
+}
@@ -0,0 +1,45 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+
+// How often the matrix is scanned in the background
+#ifndef BACKGROUND_MATRIX_SCAN_INTERVAL_US
+#    define BACKGROUND_MATRIX_SCAN_INTERVAL_US 1000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Starts scanning the matrix in the background, once the matrix has been initialised.
+ */
+void background_matrix_scan_init(void);
+
+/**
+ * Scans and debounces the matrix once, queueing an event for every key which changed state, timestamped with the time
+ * of the scan. Runs on the platform's scan timer interrupt or thread, never on the main loop.
+ */
+void background_matrix_scan_task(void);
+
+/**
+ * Takes the oldest queued key event, invoked by the main loop.
+ *
+ * @param event[out] the oldest key event
+ * @return false if no key changed state since the last call
+ */
+bool background_matrix_scan_get_event(keyevent_t *event);
+
+/**
+ * Platform specific: starts invoking background_matrix_scan_task() every BACKGROUND_MATRIX_SCAN_INTERVAL_US.
+ */
+void background_matrix_scan_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,114 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "deadline.h"
+#include "quantum.h"
+#include "debounce.h"
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
+#ifdef DEFERRED_EXEC_ENABLE
+#    include "deferred_exec.h"
+#endif
+#ifdef SOF_SYNC_ENABLE
+#    include "sof_sync.h"
+#endif
+
+// Features which poll their inputs or timers on every iteration without reporting a deadline
+#if defined(SPLIT_KEYBOARD) || defined(ENCODER_ENABLE) || defined(DIP_SWITCH_ENABLE) || defined(MOUSEKEY_ENABLE) || defined(POINTING_DEVICE_ENABLE) || defined(PS2_MOUSE_ENABLE) || defined(JOYSTICK_ENABLE) || defined(MIDI_ENABLE) || defined(AUDIO_ENABLE) || defined(HAPTIC_ENABLE) || defined(AUTO_SHIFT_ENABLE) || defined(CAPS_WORD_ENABLE) || defined(KEY_OVERRIDE_ENABLE) || (defined(LEADER_ENABLE) && !defined(LEADER_SEQUENCE_COUNT)) || defined(WPM_ENABLE) || defined(SECURE_ENABLE) || defined(SEQUENCER_ENABLE)
+#    define DEADLINE_POLLED_FEATURES
+#endif
+
+#ifdef QUANTUM_PAINTER_ENABLE
+bool qp_internal_animation_next_deadline(uint32_t *deadline);
+#endif
+
+__attribute__((weak)) bool tickless_idle_next_deadline_user(uint32_t *deadline) {
+    return false;
+}
+
+__attribute__((weak)) bool tickless_idle_next_deadline_kb(uint32_t *deadline) {
+    return tickless_idle_next_deadline_user(deadline);
+}
+
+// Custom debouncers which do not report a deadline are run on every millisecond
+__attribute__((weak)) bool debounce_next_deadline(uint32_t *deadline) {
+    *deadline = timer_read32() + 1;
+    return true;
+}
+
+static inline void pull_in(uint32_t *earliest, uint32_t deadline) {
+    if ((int32_t)TIMER_DIFF_32(deadline, *earliest) < 0) {
+        *earliest = deadline;
+    }
+}
+
+uint32_t next_deadline(uint32_t max_wait) {
+    const uint32_t now = timer_read32();
+    uint32_t       deadline;
+#ifdef DEADLINE_POLLED_FEATURES
+    uint32_t earliest = now + 1;
+#else
+    uint32_t earliest = now + max_wait;
+#endif
+
+#ifdef TASK_SCHEDULER_ENABLE
+    // Tasks without a period or deadline hook are polled, at the same rate as the matrix
+    for (uint8_t i = 0; i < get_keyboard_task_count(); ++i) {
+        const scheduled_task_t *task = get_keyboard_task(i);
+        if (task->period || task->next_deadline) {
+            pull_in(&earliest, get_keyboard_task_state(i)->next_run);
+        }
+    }
+#endif
+
+    if (debounce_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#ifndef NO_ACTION_TAPPING
+    if (action_tapping_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifndef NO_ACTION_ONESHOT
+    if (oneshot_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifdef COMBO_ENABLE
+    if (combo_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifdef TAP_DANCE_ENABLE
+    if (tap_dance_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_COUNT)
+    if (leader_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifdef DEFERRED_EXEC_ENABLE
+    if (deferred_exec_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifdef QUANTUM_PAINTER_ENABLE
+    if (qp_internal_animation_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+#ifdef SOF_SYNC_ENABLE
+    // Wakes up to scan right before the host polls
+    if (sof_sync_next_deadline(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+#endif
+    if (tickless_idle_next_deadline_kb(&deadline)) {
+        pull_in(&earliest, deadline);
+    }
+
+    return (int32_t)TIMER_DIFF_32(earliest, now) < 0 ? now : earliest;
+}
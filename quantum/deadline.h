@@ -0,0 +1,35 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Works out when the main loop next has something to do: a scheduled task, a tapping, combo, tap dance or one shot
+ * timeout, a deferred execution, or a key being debounced. Shared by tickless idle and the virtual clock of the test
+ * platform.
+ *
+ * @param max_wait how far ahead to look when nothing is due, in milliseconds. Features which poll their inputs or
+ * timers without reporting a deadline limit it to 1ms.
+ * @return the absolute time of the next deadline -- equivalent time-space as timer_read32()
+ */
+uint32_t next_deadline(uint32_t max_wait);
+
+/**
+ * Optional hooks for keyboard and keymap level timers, which would otherwise only be serviced once `max_wait` is up.
+ *
+ * @param deadline[out] the absolute time of the next deadline -- equivalent time-space as timer_read32()
+ * @return true if a deadline was reported
+ */
+bool tickless_idle_next_deadline_kb(uint32_t *deadline);
+bool tickless_idle_next_deadline_user(uint32_t *deadline);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,6 +12,15 @@
  */
 bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
 
+/**
+ * @brief Reports when the debouncer next needs to run while a key is still being debounced, so that sleeping between
+ * matrix scans does not delay the key.
+ *
+ * @param deadline[out] the absolute time of the next deadline -- equivalent time-space as timer_read32()
+ * @return true if a key is being debounced
+ */
+bool debounce_next_deadline(uint32_t *deadline);
+
 void debounce_init(uint8_t num_rows);
 
 void debounce_free(void);
@@ -29,4 +29,8 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     return cooked_changed;
 }
 
+bool debounce_next_deadline(uint32_t *deadline) {
+    return false;
+}
+
 void debounce_free(void) {}
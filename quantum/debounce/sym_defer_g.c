@@ -50,6 +50,16 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     return cooked_changed;
 }
 
+bool debounce_next_deadline(uint32_t *deadline) {
+    if (!debouncing) {
+        return false;
+    }
+
+    fast_timer_t elapsed = timer_elapsed_fast(debouncing_time);
+    *deadline            = timer_read32() + (elapsed < DEBOUNCE ? DEBOUNCE - elapsed : 0);
+    return true;
+}
+
 void debounce_free(void) {}
 #else // no debouncing.
 #    include "none.c"
@@ -140,6 +140,15 @@ static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], u
     }
 }
 
+bool debounce_next_deadline(uint32_t *deadline) {
+    if (!counters_need_update) {
+        return false;
+    }
+
+    *deadline = timer_read32() + 1;
+    return true;
+}
+
 #else
 #    include "none.c"
 #endif
@@ -0,0 +1,190 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm which only keeps counters for the keys being debounced. Behaves like sym_defer_pk, but
+instead of a counter for every key, the running counters are kept in a list of DEBOUNCE_SPARSE_SLOTS entries, so the
+cost of a scan depends on how many keys are in motion rather than on the size of the matrix.
+When more keys change at once than the list holds, the excess keys share a single counter, which restarts whenever
+another key joins it. They are still debounced, only their changes may be pushed a little later.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#ifndef DEBOUNCE_SPARSE_SLOTS
+#    define DEBOUNCE_SPARSE_SLOTS 16
+#endif
+
+#if DEBOUNCE_SPARSE_SLOTS < 1 || DEBOUNCE_SPARSE_SLOTS > UINT8_MAX
+#    error "DEBOUNCE_SPARSE_SLOTS must be between 1 and 255"
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef uint8_t debounce_counter_t;
+
+typedef struct {
+    uint8_t            row;
+    uint8_t            col;
+    debounce_counter_t counter;
+} debounce_slot_t;
+
+#if DEBOUNCE > 0
+static debounce_slot_t    slots[DEBOUNCE_SPARSE_SLOTS];
+static uint8_t            slot_count;
+static matrix_row_t       slotted[MATRIX_ROWS];
+static matrix_row_t       overflowed[MATRIX_ROWS];
+static debounce_counter_t overflow_counter;
+static fast_timer_t       last_time;
+static bool               counters_need_update;
+static bool               cooked_changed;
+
+#    define DEBOUNCE_ELAPSED 0
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+void debounce_init(uint8_t num_rows) {
+    slot_count           = 0;
+    overflow_counter     = DEBOUNCE_ELAPSED;
+    counters_need_update = false;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        slotted[r]    = 0;
+        overflowed[r] = 0;
+    }
+}
+
+void debounce_free(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void transfer(matrix_row_t raw[], matrix_row_t cooked[], uint8_t row, matrix_row_t mask) {
+    matrix_row_t cooked_next = (cooked[row] & ~mask) | (raw[row] & mask);
+    cooked_changed |= cooked[row] ^ cooked_next;
+    cooked[row] = cooked_next;
+}
+
+static void remove_slot(uint8_t index) {
+    slotted[slots[index].row] &= ~(ROW_SHIFTER << slots[index].col);
+    slots[index] = slots[--slot_count];
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t i = 0; i < slot_count;) {
+        debounce_slot_t *slot = &slots[i];
+        if (slot->counter <= elapsed_time) {
+            transfer(raw, cooked, slot->row, ROW_SHIFTER << slot->col);
+            remove_slot(i);
+        } else {
+            slot->counter -= elapsed_time;
+            counters_need_update = true;
+            i++;
+        }
+    }
+
+    if (overflow_counter != DEBOUNCE_ELAPSED) {
+        if (overflow_counter <= elapsed_time) {
+            overflow_counter = DEBOUNCE_ELAPSED;
+            for (uint8_t row = 0; row < num_rows; row++) {
+                if (overflowed[row]) {
+                    transfer(raw, cooked, row, overflowed[row]);
+                    overflowed[row] = 0;
+                }
+            }
+        } else {
+            overflow_counter -= elapsed_time;
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    // Stop the counters of keys which are back to their debounced state
+    for (uint8_t i = 0; i < slot_count;) {
+        if ((raw[slots[i].row] ^ cooked[slots[i].row]) & (ROW_SHIFTER << slots[i].col)) {
+            i++;
+        } else {
+            remove_slot(i);
+        }
+    }
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        const matrix_row_t delta = raw[row] ^ cooked[row];
+
+        overflowed[row] &= delta;
+        matrix_row_t fresh = delta & ~slotted[row] & ~overflowed[row];
+
+        // Start counters for keys which just changed, spilling over into the shared counter once all slots are taken
+        for (uint8_t col = 0; fresh; col++) {
+            const matrix_row_t mask = ROW_SHIFTER << col;
+            if (!(fresh & mask)) {
+                continue;
+            }
+            fresh &= ~mask;
+
+            if (slot_count < DEBOUNCE_SPARSE_SLOTS) {
+                slots[slot_count++] = (debounce_slot_t){.row = row, .col = col, .counter = DEBOUNCE};
+                slotted[row] |= mask;
+            } else {
+                overflowed[row] |= mask;
+                overflow_counter = DEBOUNCE;
+            }
+            counters_need_update = true;
+        }
+    }
+}
+
+bool debounce_next_deadline(uint32_t *deadline) {
+    if (!counters_need_update) {
+        return false;
+    }
+
+    *deadline = timer_read32() + 1;
+    return true;
+}
+
+#else
+#    include "none.c"
+#endif
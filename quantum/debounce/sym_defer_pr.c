@@ -32,6 +32,8 @@ static uint8_t* countdowns;
 // [row]
 static matrix_row_t* last_raw;
 
+static bool counting;
+
 void debounce_init(uint8_t num_rows) {
     countdowns = (uint8_t*)calloc(num_rows, sizeof(uint8_t));
     last_raw   = (matrix_row_t*)calloc(num_rows, sizeof(matrix_row_t));
@@ -54,6 +56,7 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     bool    cooked_changed = false;
 
     uint8_t* countdown = countdowns;
+    counting           = false;
 
     for (uint8_t row = 0; row < num_rows; ++row, ++countdown) {
         matrix_row_t raw_row = raw[row];
@@ -68,6 +71,7 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
             cooked[row] = raw_row;
             *countdown  = 0;
         }
+        counting |= *countdown != 0;
     }
 
     return cooked_changed;
@@ -76,3 +80,12 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 bool debounce_active(void) {
     return true;
 }
+
+bool debounce_next_deadline(uint32_t* deadline) {
+    if (!counting) {
+        return false;
+    }
+
+    *deadline = timer_read32() + 1;
+    return true;
+}
@@ -0,0 +1,186 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm using vertical counters. Behaves exactly like sym_defer_pk, but instead of an 8-bit
+counter per key, the counters of a row are stored as bit-planes: bit N of every counter in the row is held in one
+matrix_row_t. A whole row is then counted down with a handful of bitwise operations, however many columns it has.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+// Number of bit-planes needed to hold DEBOUNCE
+#if DEBOUNCE < 2
+#    define COUNTER_BITS 1
+#elif DEBOUNCE < 4
+#    define COUNTER_BITS 2
+#elif DEBOUNCE < 8
+#    define COUNTER_BITS 3
+#elif DEBOUNCE < 16
+#    define COUNTER_BITS 4
+#elif DEBOUNCE < 32
+#    define COUNTER_BITS 5
+#elif DEBOUNCE < 64
+#    define COUNTER_BITS 6
+#elif DEBOUNCE < 128
+#    define COUNTER_BITS 7
+#else
+#    define COUNTER_BITS 8
+#endif
+
+#define COUNTER_MAX ((1 << COUNTER_BITS) - 1)
+
+// Selects every column in a bit-plane where the given bit of value is set
+#define PLANE_MASK(value, bit) (((value) >> (bit)) & 1 ? (matrix_row_t)~(matrix_row_t)0 : (matrix_row_t)0)
+
+typedef struct {
+    matrix_row_t planes[COUNTER_BITS];
+} debounce_counters_t;
+
+#if DEBOUNCE > 0
+static debounce_counters_t *debounce_counters;
+static fast_timer_t         last_time;
+static bool                 counters_need_update;
+static bool                 cooked_changed;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    debounce_counters = (debounce_counters_t *)malloc(num_rows * sizeof(debounce_counters_t));
+    for (uint8_t r = 0; r < num_rows; r++) {
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            debounce_counters[r].planes[bit] = 0;
+        }
+    }
+}
+
+void debounce_free(void) {
+    free(debounce_counters);
+    debounce_counters = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        // Every counter is at most DEBOUNCE, so anything longer expires them all
+        if (elapsed_time > COUNTER_MAX) {
+            elapsed_time = COUNTER_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t *planes = debounce_counters[row].planes;
+        matrix_row_t  active = 0;
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            active |= planes[bit];
+        }
+        if (!active) {
+            continue;
+        }
+
+        // Subtract elapsed_time from every running counter in the row at once, rippling the borrow through the planes
+        matrix_row_t borrow    = 0;
+        matrix_row_t remaining = 0;
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            const matrix_row_t counter = planes[bit];
+            const matrix_row_t elapsed = PLANE_MASK(elapsed_time, bit) & active;
+
+            planes[bit] = counter ^ elapsed ^ borrow;
+            borrow      = (~counter & (elapsed | borrow)) | (elapsed & borrow);
+            remaining |= planes[bit];
+        }
+
+        // Counters which reached zero or went past it have expired
+        const matrix_row_t expired = active & (borrow | ~remaining);
+        if (expired) {
+            for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+                planes[bit] &= ~expired;
+            }
+            matrix_row_t cooked_next = (cooked[row] & ~expired) | (raw[row] & expired);
+            cooked_changed |= cooked[row] ^ cooked_next;
+            cooked[row] = cooked_next;
+        }
+        if (active & ~expired) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t      *planes = debounce_counters[row].planes;
+        const matrix_row_t delta  = raw[row] ^ cooked[row];
+        matrix_row_t       active = 0;
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            active |= planes[bit];
+        }
+
+        // Start the counters of keys which changed, and stop those of keys which changed back
+        const matrix_row_t start = delta & ~active;
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            planes[bit] = (planes[bit] & delta) | (start & PLANE_MASK(DEBOUNCE, bit));
+        }
+        if (start) {
+            counters_need_update = true;
+        }
+    }
+}
+
+bool debounce_next_deadline(uint32_t *deadline) {
+    if (!counters_need_update) {
+        return false;
+    }
+
+    *deadline = timer_read32() + 1;
+    return true;
+}
+
+#else
+#    include "none.c"
+#endif
@@ -145,6 +145,15 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
     }
 }
 
+bool debounce_next_deadline(uint32_t *deadline) {
+    if (!counters_need_update) {
+        return false;
+    }
+
+    *deadline = timer_read32() + 1;
+    return true;
+}
+
 #else
 #    include "none.c"
 #endif
@@ -0,0 +1,298 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+
+namespace {
+
+bool   counting_allocations = false;
+size_t allocated_bytes      = 0;
+
+} // namespace
+
+#ifdef DEBOUNCE_BENCH_WRAP_MALLOC
+/* Linked in place of malloc() and calloc(), to count what the algorithm allocates */
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__wrap_malloc(size_t size) {
+    if (counting_allocations) {
+        allocated_bytes += size;
+    }
+    return __real_malloc(size);
+}
+
+extern "C" void *__real_calloc(size_t count, size_t size);
+extern "C" void *__wrap_calloc(size_t count, size_t size) {
+    if (counting_allocations) {
+        allocated_bytes += count * size;
+    }
+    return __real_calloc(count, size);
+}
+#endif
+
+namespace {
+
+/* A change of the raw input of one key, as read by a 1kHz matrix scan */
+struct RawChange {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+};
+
+/* A key being pressed or released, which ends up as one or more raw changes when the switch bounces */
+struct KeyTransition {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+struct Trace {
+    std::string                name;
+    uint32_t                   duration;
+    std::vector<KeyTransition> transitions;
+    std::vector<RawChange>     changes;
+};
+
+struct Result {
+    double   ns_per_scan;
+    size_t   heap_bytes;
+    double   mean_latency;
+    uint32_t max_latency;
+    size_t   missed;
+};
+
+constexpr uint32_t kSettleTime = 100;
+
+void sort_trace(Trace &trace) {
+    std::stable_sort(trace.transitions.begin(), trace.transitions.end(), [](const KeyTransition &a, const KeyTransition &b) { return a.time < b.time; });
+    std::stable_sort(trace.changes.begin(), trace.changes.end(), [](const RawChange &a, const RawChange &b) { return a.time < b.time; });
+}
+
+/* Adds a transition, bouncing an even number of extra times within bounce_ms so that it settles in the new state */
+void add_transition(Trace &trace, std::mt19937 &rng, uint32_t time, uint8_t row, uint8_t col, bool pressed, uint32_t bounce_ms) {
+    trace.transitions.push_back({time, row, col, pressed});
+    trace.changes.push_back({time, row, col});
+
+    if (bounce_ms > 1) {
+        std::uniform_int_distribution<uint32_t> bounces(0, 2);
+        std::uniform_int_distribution<uint32_t> offset(1, bounce_ms - 1);
+        std::vector<uint32_t>                   offsets;
+        for (uint32_t i = 2 * bounces(rng); i > 0; i--) {
+            offsets.push_back(offset(rng));
+        }
+        std::sort(offsets.begin(), offsets.end());
+        for (auto o : offsets) {
+            trace.changes.push_back({time + o, row, col});
+        }
+    }
+}
+
+/* Keys pressed one after the other with overlapping holds, at the given number of keys per second */
+Trace typing_trace(const char *name, uint32_t keys_per_second, uint32_t bounce_ms) {
+    std::mt19937                            rng(1234);
+    std::uniform_int_distribution<uint8_t>  row(0, MATRIX_ROWS - 1);
+    std::uniform_int_distribution<uint8_t>  col(0, MATRIX_COLS - 1);
+    std::uniform_int_distribution<uint32_t> hold(40, 150);
+    std::vector<uint32_t>                   busy_until(MATRIX_ROWS * MATRIX_COLS, 0);
+    Trace                                   trace{name, 10000, {}, {}};
+
+    for (uint32_t time = 10; time + 200 < trace.duration; time += 1000 / keys_per_second) {
+        uint8_t r = row(rng), c = col(rng);
+        if (busy_until[r * MATRIX_COLS + c] > time) {
+            continue;
+        }
+        uint32_t release = time + hold(rng);
+        add_transition(trace, rng, time, r, c, true, bounce_ms);
+        add_transition(trace, rng, release, r, c, false, bounce_ms);
+        busy_until[r * MATRIX_COLS + c] = release + 40;
+    }
+
+    sort_trace(trace);
+    return trace;
+}
+
+/* Recorded raw changes, one "<time ms> <row> <col>" line per change, with every key starting released */
+Trace recorded_trace(const std::string &path) {
+    std::ifstream         file(path);
+    Trace                 trace{"recorded", 0, {}, {}};
+    std::vector<bool>     state(MATRIX_ROWS * MATRIX_COLS, false);
+    std::vector<uint32_t> last_change(MATRIX_ROWS * MATRIX_COLS, 0);
+    uint32_t              time, row, col;
+
+    // A change is the start of a new transition unless the key changed within the last 10ms
+    while (file >> time >> row >> col) {
+        if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            continue;
+        }
+        size_t key = row * MATRIX_COLS + col;
+        state[key] = !state[key];
+        if (last_change[key] == 0 || time - last_change[key] > 10) {
+            trace.transitions.push_back({time, (uint8_t)row, (uint8_t)col, state[key]});
+        }
+        last_change[key] = time;
+        trace.changes.push_back({time, (uint8_t)row, (uint8_t)col});
+        trace.duration = std::max(trace.duration, time + 1);
+    }
+
+    sort_trace(trace);
+    return trace;
+}
+
+class DebounceBenchmark : public ::testing::Test {
+   protected:
+    static constexpr uint32_t time_offset = 7777;
+
+    matrix_row_t raw[MATRIX_ROWS];
+    matrix_row_t cooked[MATRIX_ROWS];
+
+    /* Runs the trace once without any measurement overhead for the timing, then once more to check the output */
+    Result run(const Trace &trace) {
+        const uint32_t scans = trace.duration + kSettleTime;
+        Result         result{};
+
+        /* Timing */
+        std::fill(std::begin(raw), std::end(raw), 0);
+        std::fill(std::begin(cooked), std::end(cooked), 0);
+        set_time(time_offset);
+
+        allocated_bytes      = 0;
+        counting_allocations = true;
+        debounce_init(MATRIX_ROWS);
+        counting_allocations = false;
+        result.heap_bytes    = allocated_bytes;
+
+        auto change = trace.changes.begin();
+        auto start  = std::chrono::steady_clock::now();
+        for (uint32_t time = 0; time < scans; time++) {
+            bool changed = false;
+            for (; change != trace.changes.end() && change->time <= time; ++change) {
+                raw[change->row] ^= MATRIX_ROW_SHIFTER << change->col;
+                changed = true;
+            }
+            debounce(raw, cooked, MATRIX_ROWS, changed);
+            advance_time(1);
+        }
+        auto elapsed       = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        result.ns_per_scan = (double)elapsed / scans;
+        debounce_free();
+
+        /* Latency, from the first raw change of a transition to the cooked matrix following it */
+        std::vector<int64_t> pending(MATRIX_ROWS * MATRIX_COLS, -1);
+        std::vector<bool>    intended(MATRIX_ROWS * MATRIX_COLS, false);
+        uint64_t             total_latency = 0;
+        size_t               measured      = 0;
+
+        std::fill(std::begin(raw), std::end(raw), 0);
+        std::fill(std::begin(cooked), std::end(cooked), 0);
+        set_time(time_offset);
+        debounce_init(MATRIX_ROWS);
+
+        change          = trace.changes.begin();
+        auto transition = trace.transitions.begin();
+        for (uint32_t time = 0; time < scans; time++) {
+            for (; transition != trace.transitions.end() && transition->time <= time; ++transition) {
+                size_t key = transition->row * MATRIX_COLS + transition->col;
+                if (pending[key] >= 0) {
+                    result.missed++;
+                }
+                pending[key]  = time;
+                intended[key] = transition->pressed;
+            }
+
+            bool changed = false;
+            for (; change != trace.changes.end() && change->time <= time; ++change) {
+                raw[change->row] ^= MATRIX_ROW_SHIFTER << change->col;
+                changed = true;
+            }
+
+            matrix_row_t previous[MATRIX_ROWS];
+            std::copy(std::begin(cooked), std::end(cooked), std::begin(previous));
+            debounce(raw, cooked, MATRIX_ROWS, changed);
+
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                matrix_row_t delta = previous[row] ^ cooked[row];
+                for (uint8_t col = 0; delta && col < MATRIX_COLS; col++) {
+                    size_t key = row * MATRIX_COLS + col;
+                    if ((delta & (MATRIX_ROW_SHIFTER << col)) && pending[key] >= 0 && !!(cooked[row] & (MATRIX_ROW_SHIFTER << col)) == intended[key]) {
+                        uint32_t latency = time - pending[key];
+                        total_latency += latency;
+                        result.max_latency = std::max(result.max_latency, latency);
+                        measured++;
+                        pending[key] = -1;
+                    }
+                }
+            }
+            advance_time(1);
+        }
+        result.mean_latency = measured ? (double)total_latency / measured : 0;
+        result.missed += std::count_if(pending.begin(), pending.end(), [](int64_t p) { return p >= 0; });
+
+        // Whatever happened on the way, the output must settle on the input
+        EXPECT_TRUE(std::equal(std::begin(raw), std::end(raw), std::begin(cooked))) << "Debounced matrix did not settle for the " << trace.name << " trace";
+        debounce_free();
+
+        return result;
+    }
+
+    static void report(const Trace &trace, const Result &result) {
+        std::cout << "[ BENCH    ] debounce " STR(DEBOUNCE_BENCH_TYPE) " " << MATRIX_ROWS << "x" << MATRIX_COLS << " " << trace.name << ": " << std::fixed << std::setprecision(1) << result.ns_per_scan << "ns per scan, " << result.heap_bytes << " bytes allocated, latency mean " << result.mean_latency << "ms max " << result.max_latency << "ms, " << result.missed << " of " << trace.transitions.size() << " transitions missed" << std::endl;
+
+        /* Ends up in the JSON results of `make bench` */
+        std::ostringstream ns_per_scan;
+        ns_per_scan << std::fixed << std::setprecision(1) << result.ns_per_scan;
+        RecordProperty("ns_per_scan", ns_per_scan.str());
+        RecordProperty("heap_bytes", (int)result.heap_bytes);
+        RecordProperty("max_latency_ms", (int)result.max_latency);
+        RecordProperty("missed_transitions", (int)result.missed);
+    }
+};
+
+} // namespace
+
+TEST_F(DebounceBenchmark, Idle) {
+    Trace trace{"idle", 10000, {}, {}};
+    report(trace, run(trace));
+}
+
+TEST_F(DebounceBenchmark, Typing) {
+    Trace trace = typing_trace("typing", 10, 3);
+    report(trace, run(trace));
+}
+
+TEST_F(DebounceBenchmark, FastTypingWithLongBounces) {
+    Trace trace = typing_trace("fast_typing", 25, DEBOUNCE);
+    report(trace, run(trace));
+}
+
+TEST_F(DebounceBenchmark, Recorded) {
+    const char *path = std::getenv("DEBOUNCE_BENCH_TRACE");
+    if (!path) {
+        GTEST_SKIP() << "Set DEBOUNCE_BENCH_TRACE to the path of a recorded trace";
+    }
+    Trace trace = recorded_trace(path);
+    ASSERT_FALSE(trace.changes.empty()) << "No changes read from " << path;
+    report(trace, run(trace));
+}
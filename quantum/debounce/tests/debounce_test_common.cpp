@@ -59,6 +59,7 @@ void DebounceTest::runEventsInternal() {
     /* Initialise keyboard with start time (offset to avoid testing at 0) and all keys UP */
     debounce_init(MATRIX_ROWS);
     set_time(time_offset_);
+    has_deadline_ = false;
     std::fill(std::begin(input_matrix_), std::end(input_matrix_), 0);
     std::fill(std::begin(output_matrix_), std::end(output_matrix_), 0);
 
@@ -88,6 +89,15 @@ void DebounceTest::runEventsInternal() {
             matrixUpdate(input_matrix_, "input", input);
         }
 
+        /* Changes that only depend on time passing must have been reported as a deadline, so that sleeping until
+         * the next deadline does not delay them */
+        if (event.inputs_.empty() && !event.outputs_.empty()) {
+            EXPECT_TRUE(has_deadline_) << "debounce_next_deadline() did not report a deadline before " << strTime();
+            if (has_deadline_) {
+                EXPECT_LE((int32_t)TIMER_DIFF_32(deadline_, timer_read32()), 0) << "debounce_next_deadline() reported " << (deadline_ - time_offset_) << ", after " << strTime();
+            }
+        }
+
         /* Call debounce */
         runDebounce(!event.inputs_.empty());
 
@@ -126,6 +136,7 @@ void DebounceTest::runDebounce(bool changed) {
     std::copy(std::begin(output_matrix_), std::end(output_matrix_), std::begin(cooked_matrix_));
 
     bool cooked_changed = debounce(raw_matrix_, cooked_matrix_, MATRIX_ROWS, changed);
+    has_deadline_       = debounce_next_deadline(&deadline_);
 
     if (!std::equal(std::begin(input_matrix_), std::end(input_matrix_), std::begin(raw_matrix_))) {
         FAIL() << "Fatal error: debounce() modified raw matrix at " << strTime() << "\ninput_matrix: changed=" << changed << "\n" << strMatrix(input_matrix_) << "\nraw_matrix:\n" << strMatrix(raw_matrix_);
@@ -78,4 +78,7 @@ class DebounceTest : public ::testing::Test {
 
     int  extra_iterations_;
     bool auto_advance_time_;
+
+    bool     has_deadline_;
+    uint32_t deadline_;
 };
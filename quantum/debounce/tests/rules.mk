@@ -33,6 +33,16 @@ debounce_sym_defer_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_defer_pr.c \
 	$(QUANTUM_PATH)/debounce/tests/sym_defer_pr_tests.cpp
 
+debounce_sym_defer_pk_sparse_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_SPARSE_SLOTS=4
+debounce_sym_defer_pk_sparse_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_sparse.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_sparse_tests.cpp
+
+debounce_sym_defer_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_vc_tests.cpp
+
 debounce_sym_eager_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_sym_eager_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_eager_pk.c \
@@ -47,3 +57,20 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+# Benchmarks, named debounce_bench_<DEBOUNCE_TYPE>_<rows>x<cols>
+ifneq ($(filter debounce_bench_%,$(TEST)),)
+    DEBOUNCE_BENCH_SIZE := $(lastword $(subst _, ,$(TEST)))
+    DEBOUNCE_BENCH_TYPE := $(patsubst debounce_bench_%_$(DEBOUNCE_BENCH_SIZE),%,$(TEST))
+
+    $(TEST)_DEFS := -DMATRIX_ROWS=$(word 1,$(subst x, ,$(DEBOUNCE_BENCH_SIZE))) -DMATRIX_COLS=$(word 2,$(subst x, ,$(DEBOUNCE_BENCH_SIZE))) -DDEBOUNCE=5 -DDEBOUNCE_BENCH_TYPE=$(DEBOUNCE_BENCH_TYPE)
+    $(TEST)_SRC := $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+        $(QUANTUM_PATH)/debounce/$(DEBOUNCE_BENCH_TYPE).c \
+        $(QUANTUM_PATH)/debounce/tests/debounce_benchmark.cpp
+
+    # Count the bytes allocated by debounce_init()
+    ifeq ($(shell uname -s),Linux)
+        $(TEST)_DEFS += -DDEBOUNCE_BENCH_WRAP_MALLOC
+        LDFLAGS += -Wl,--wrap=malloc -Wl,--wrap=calloc
+    endif
+endif
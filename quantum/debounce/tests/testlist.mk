@@ -1,7 +1,14 @@
 TEST_LIST += \
 	debounce_sym_defer_g \
 	debounce_sym_defer_pk \
+	debounce_sym_defer_pk_sparse \
 	debounce_sym_defer_pr \
+	debounce_sym_defer_vc \
 	debounce_sym_eager_pk \
 	debounce_sym_eager_pr \
 	debounce_asym_eager_defer_pk
+
+DEBOUNCE_BENCH_TYPES := sym_defer_g sym_defer_pk sym_defer_pk_sparse sym_defer_pr sym_defer_vc sym_eager_pk sym_eager_pr asym_eager_defer_pk
+DEBOUNCE_BENCH_SIZES := 4x12 8x16 16x32
+
+DEBOUNCE_BENCH_LIST := $(foreach type,$(DEBOUNCE_BENCH_TYPES),$(foreach size,$(DEBOUNCE_BENCH_SIZES),debounce_bench_$(type)_$(size)))
@@ -9,34 +9,131 @@
 #    define MAX_DEFERRED_EXECUTORS 8
 #endif
 
+// Slot numbers are stored in a uint8_t, and encoded in the low bits of the token alongside a zero-means-invalid offset
+#define MAX_TABLE_COUNT 255
+
 //------------------------------------
 // Helpers
 //
+// Executors stay in their table slot for their whole lifetime, while a binary min-heap of slot numbers ordered by
+// trigger time is kept alongside them. Heap positions [0, count) hold the pending executors, positions [count, n) hold
+// the free slots. Both mappings are XOR-encoded against their own index so that a zero-initialised table starts out
+// with the identity mapping, i.e. every slot free.
+//
 
-static deferred_token current_token = 0;
+static inline uint8_t slot_at(deferred_executor_t *table, uint8_t pos) {
+    return table[pos].heap_slot ^ pos;
+}
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
+static inline uint8_t position_of(deferred_executor_t *table, uint8_t slot) {
+    return table[slot].heap_index ^ slot;
+}
+
+static inline void place(deferred_executor_t *table, uint8_t pos, uint8_t slot) {
+    table[pos].heap_slot   = slot ^ pos;
+    table[slot].heap_index = pos ^ slot;
+}
+
+static inline bool is_earlier(deferred_executor_t *table, uint8_t pos_a, uint8_t pos_b) {
+    return ((int32_t)TIMER_DIFF_32(table[slot_at(table, pos_a)].trigger_time, table[slot_at(table, pos_b)].trigger_time)) < 0;
+}
+
+static inline void swap_positions(deferred_executor_t *table, uint8_t pos_a, uint8_t pos_b) {
+    uint8_t slot_a = slot_at(table, pos_a);
+    place(table, pos_a, slot_at(table, pos_b));
+    place(table, pos_b, slot_a);
+}
+
+static uint8_t pending_count(deferred_executor_t *table, size_t table_count) {
+    // Pending executors occupy a prefix of the heap, so the boundary can be binary searched
+    uint8_t lo = 0, hi = table_count;
+    while (lo < hi) {
+        uint8_t mid = lo + (hi - lo) / 2;
+        if (table[slot_at(table, mid)].token != INVALID_DEFERRED_TOKEN) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
+    return lo;
+}
+
+static void sift_up(deferred_executor_t *table, uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!is_earlier(table, pos, parent)) {
+            break;
         }
+        swap_positions(table, pos, parent);
+        pos = parent;
     }
-    return true;
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void sift_down(deferred_executor_t *table, uint8_t count, uint8_t pos) {
+    while (true) {
+        uint16_t child = 2 * pos + 1;
+        if (child >= count) {
+            break;
         }
+        if (child + 1 < count && is_earlier(table, child + 1, child)) {
+            ++child;
+        }
+        if (!is_earlier(table, child, pos)) {
+            break;
+        }
+        swap_positions(table, pos, child);
+        pos = child;
+    }
+}
+
+// Tokens hold the slot number plus one in the low bits, and the generation of the slot in the bits the table size
+// leaves spare, so that a token is not handed out again until its slot has been reused that many times
+static uint8_t slot_bits(size_t table_count) {
+    uint8_t bits = 1;
+    while (bits < 8 && (1u << bits) <= table_count) {
+        ++bits;
+    }
+    return bits;
+}
+
+static deferred_token make_token(size_t table_count, uint8_t slot, uint8_t generation) {
+    uint8_t bits = slot_bits(table_count);
+    return (deferred_token)((bits < 8 ? generation << bits : 0) | (slot + 1));
+}
+
+static deferred_executor_t *lookup_token(deferred_executor_t *table, size_t table_count, deferred_token token) {
+    uint8_t slot = (token & ((1u << slot_bits(table_count)) - 1)) - 1;
+    if (token == INVALID_DEFERRED_TOKEN || slot >= table_count || table[slot].token != token) {
+        return NULL;
+    }
+    return &table[slot];
+}
+
+static void remove_executor(deferred_executor_t *table, size_t table_count, uint8_t slot) {
+    uint8_t count = pending_count(table, table_count);
+    uint8_t pos   = position_of(table, slot);
+    uint8_t last  = count - 1;
+
+    // Move the last pending executor into the hole, then clear the slot which is now just past the pending prefix
+    swap_positions(table, pos, last);
+    table[slot].token        = INVALID_DEFERRED_TOKEN;
+    table[slot].trigger_time = 0;
+    table[slot].callback     = NULL;
+    table[slot].cb_arg       = NULL;
+
+    if (pos < last) {
+        sift_up(table, pos);
+        sift_down(table, last, pos);
     }
-    return current_token;
+}
+
+static void reschedule_executor(deferred_executor_t *table, size_t table_count, uint8_t slot, uint32_t trigger_time) {
+    uint8_t count = pending_count(table, table_count);
+    uint8_t pos   = position_of(table, slot);
+
+    table[slot].trigger_time = trigger_time;
+    sift_up(table, pos);
+    sift_down(table, count, position_of(table, slot));
 }
 
 //------------------------------------
@@ -45,74 +142,74 @@ static inline deferred_token allocate_token(deferred_executor_t *table, size_t t
 
 deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_count, uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || !callback) {
+    if (!table || table_count == 0 || table_count > MAX_TABLE_COUNT || delay_ms == 0 || !callback) {
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
-
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
-        }
+    // Claim the first free slot, if there are none available then bail out
+    uint8_t count = pending_count(table, table_count);
+    if (count >= table_count) {
+        return INVALID_DEFERRED_TOKEN;
     }
+    uint8_t slot = slot_at(table, count);
 
-    // None available
-    return INVALID_DEFERRED_TOKEN;
+    // Set up the executor table entry, the generation avoids handing out the same token for a reused slot
+    deferred_executor_t *entry = &table[slot];
+    entry->token               = make_token(table_count, slot, ++entry->generation);
+    entry->trigger_time        = timer_read32() + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    sift_up(table, count);
+    return entry->token;
 }
 
 bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token, uint32_t delay_ms) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table || table_count == 0 || table_count > MAX_TABLE_COUNT || delay_ms == 0) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = lookup_token(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    reschedule_executor(table, table_count, entry - table, timer_read32() + delay_ms);
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
     // Ignore request if the table/token are not valid
-    if (!table || table_count == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table || table_count == 0 || table_count > MAX_TABLE_COUNT) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    deferred_executor_t *entry = lookup_token(table, table_count, token);
+    if (!entry) {
+        return false;
+    }
+
+    // Found it, cancel and clear the table entry
+    remove_executor(table, table_count, entry - table);
+    return true;
+}
+
+bool deferred_exec_advanced_next_deadline(deferred_executor_t *table, size_t table_count, uint32_t *deadline) {
+    if (!table || table_count == 0 || table_count > MAX_TABLE_COUNT) {
+        return false;
+    }
+
+    // The earliest executor is always at the top of the heap
+    deferred_executor_t *entry = &table[slot_at(table, 0)];
+    if (entry->token == INVALID_DEFERRED_TOKEN) {
+        return false;
     }
 
-    // Not found
-    return false;
+    *deadline = entry->trigger_time;
+    return true;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
@@ -122,29 +219,41 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
     if (((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
         *last_execution_time = now;
 
-        // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
-            deferred_executor_t *entry = &table[i];
+        if (!table || table_count == 0 || table_count > MAX_TABLE_COUNT) {
+            return;
+        }
+
+        // Run through each of the due executors, earliest first. Limit the number of invocations to the number of
+        // executors pending at the start, so that a callback which is still due after being requeued cannot starve
+        // the main loop.
+        for (uint8_t budget = pending_count(table, table_count); budget > 0; --budget) {
+            uint8_t              slot  = slot_at(table, 0);
+            deferred_executor_t *entry = &table[slot];
 
             // Check if we're supposed to execute this entry
-            if (entry->token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
-                }
+            if (entry->token == INVALID_DEFERRED_TOKEN || ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+                break;
+            }
+
+            // Invoke the callback and work work out if we should be requeued
+            uint8_t  generation = entry->generation;
+            uint32_t delay_ms   = entry->callback(entry->trigger_time, entry->cb_arg);
+
+            // The callback may have cancelled itself, in which case the slot may already be in use by someone else
+            if (entry->token == INVALID_DEFERRED_TOKEN || entry->generation != generation) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                reschedule_executor(table, table_count, slot, entry->trigger_time + delay_ms);
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                remove_executor(table, table_count, slot);
             }
         }
     }
@@ -166,6 +275,9 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
 bool cancel_deferred_exec(deferred_token token) {
     return cancel_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token);
 }
+bool deferred_exec_next_deadline(uint32_t *deadline) {
+    return deferred_exec_advanced_next_deadline(basic_executors, MAX_DEFERRED_EXECUTORS, deadline);
+}
 void deferred_exec_task(void) {
     deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
 }
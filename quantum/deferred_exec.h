@@ -13,6 +13,9 @@
 
 /**
  * @typedef A token that can be used to cancel or extend an existing deferred execution.
+ *
+ * A token stays unique while its deferred execution is pending. Once it has finished or been cancelled, the same token
+ * is only handed out again after its slot in the table has been reused several times, 16 for the default table size.
  */
 typedef uint8_t deferred_token;
 
@@ -60,6 +63,14 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
  */
 bool cancel_deferred_exec(deferred_token token);
 
+/**
+ * Queries when the next deferred execution is due.
+ *
+ * @param deadline[out] the trigger time of the earliest pending executor -- equivalent time-space as timer_read32()
+ * @return true if an executor is pending, otherwise false
+ */
+bool deferred_exec_next_deadline(uint32_t *deadline);
+
 /**
  * Forward declaration for the main loop in order to execute any deferred executors. Should not be invoked by keyboard/user code.
  */
@@ -73,9 +84,13 @@ void deferred_exec_task(void);
  * @struct Structure for containing self-hosted deferred executor tables.
  * @brief Core-side code can use this to create their own tables without impacting on the use of users' ability to add deferred execution.
  *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in an array.
+ *        Tables must be zero-initialised, and may hold at most 255 executors.
  */
 typedef struct deferred_executor_t {
     deferred_token         token;
+    uint8_t                heap_index; // heap bookkeeping, see deferred_exec.c
+    uint8_t                heap_slot;  // heap bookkeeping, see deferred_exec.c
+    uint8_t                generation; // times this slot was used, see deferred_exec.c
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
@@ -110,6 +125,16 @@ bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
  */
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token);
 
+/**
+ * Queries when the next deferred execution in the custom table is due.
+ *
+ * @param table[in] the custom table used for storage
+ * @param table_count[in] the number of available items in the table
+ * @param deadline[out] the trigger time of the earliest pending executor -- equivalent time-space as timer_read32()
+ * @return true if an executor is pending, otherwise false
+ */
+bool deferred_exec_advanced_next_deadline(deferred_executor_t *table, size_t table_count, uint32_t *deadline);
+
 /**
  * Forward declaration for the main loop in order to execute any custom table deferred executors. Should not be invoked by keyboard/user code.
  * Needed for any custom-allocated deferred execution tables. Any core tasks should add appropriate invocation to quantum/main.c.
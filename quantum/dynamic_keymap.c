@@ -20,6 +20,10 @@
 #include "quantum.h" // for send_string()
 #include "dynamic_keymap.h"
 
+#ifdef KEYMAP_CACHE_ENABLE
+#    include "keymap_cache.h"
+#endif
+
 #ifdef VIA_ENABLE
 #    include "via.h" // for VIA_EEPROM_CONFIG_END
 #    define DYNAMIC_KEYMAP_EEPROM_START (VIA_EEPROM_CONFIG_END)
@@ -98,6 +102,24 @@ _Static_assert((DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (DYNAMIC_KEYMAP_MACRO_EEPROM_A
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+// Layers mirrored in RAM, so that looking up a key does not read the EEPROM. Layers are mirrored from layer 0 upwards,
+// so when RAM is short, keep the most used layers first and mirror only those.
+#ifndef DYNAMIC_KEYMAP_CACHE_LAYERS
+#    define DYNAMIC_KEYMAP_CACHE_LAYERS 0
+#endif
+
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > DYNAMIC_KEYMAP_LAYER_COUNT
+#    error DYNAMIC_KEYMAP_CACHE_LAYERS must not be greater than DYNAMIC_KEYMAP_LAYER_COUNT
+#endif
+
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+// Same layout as the EEPROM, so that buffer writes can be mirrored by offset
+static uint16_t ram_keymap[DYNAMIC_KEYMAP_CACHE_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+#    ifdef ENCODER_MAP_ENABLE
+static uint16_t ram_encoder_map[DYNAMIC_KEYMAP_CACHE_LAYERS][NUM_ENCODERS][2];
+#    endif // ENCODER_MAP_ENABLE
+#endif
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -109,6 +131,9 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
 
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS) return ram_keymap[layer][row][column];
+#endif
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = eeprom_read_byte(address) << 8;
@@ -122,6 +147,12 @@ void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS) ram_keymap[layer][row][column] = keycode;
+#endif
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_invalidate();
+#endif
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -131,6 +162,9 @@ void *dynamic_keymap_encoder_to_eeprom_address(uint8_t layer, uint8_t encoder_id
 
 uint16_t dynamic_keymap_get_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
+#    if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS) return ram_encoder_map[layer][encoder_id][clockwise ? 0 : 1];
+#    endif
     void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = ((uint16_t)eeprom_read_byte(address + (clockwise ? 0 : 2))) << 8;
@@ -144,9 +178,36 @@ void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwis
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
+#    if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS) ram_encoder_map[layer][encoder_id][clockwise ? 0 : 1] = keycode;
+#    endif
 }
 #endif // ENCODER_MAP_ENABLE
 
+void dynamic_keymap_init(void) {
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    // Load the mirrored layers, from then on they are kept up to date by every write
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_CACHE_LAYERS; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+                void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+                ram_keymap[layer][row][column] = ((uint16_t)eeprom_read_byte(address) << 8) | eeprom_read_byte(address + 1);
+            }
+        }
+#    ifdef ENCODER_MAP_ENABLE
+        for (uint8_t encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+            void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder);
+            ram_encoder_map[layer][encoder][0] = ((uint16_t)eeprom_read_byte(address) << 8) | eeprom_read_byte(address + 1);
+            ram_encoder_map[layer][encoder][1] = ((uint16_t)eeprom_read_byte(address + 2) << 8) | eeprom_read_byte(address + 3);
+        }
+#    endif // ENCODER_MAP_ENABLE
+    }
+#endif
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_invalidate();
+#endif
+}
+
 void dynamic_keymap_reset(void) {
     // Reset the keymaps in EEPROM to what is in flash.
     for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
@@ -195,10 +256,20 @@ void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
             eeprom_update_byte(target, *source);
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+            if (offset + i < sizeof(ram_keymap)) {
+                // Keycodes are stored big endian
+                uint16_t *entry = &((uint16_t *)ram_keymap)[(offset + i) / 2];
+                *entry          = ((offset + i) % 2) ? ((*entry & 0xFF00) | *source) : ((*entry & 0x00FF) | (*source << 8));
+            }
+#endif
         }
         source++;
         target++;
     }
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_invalidate();
+#endif
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -18,6 +18,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Loads the layers mirrored in RAM, invoked by keyboard_init()
+void     dynamic_keymap_init(void);
 uint8_t  dynamic_keymap_get_layer_count(void);
 void *   dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column);
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column);
@@ -0,0 +1,101 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+
+const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    {{KC_A, KC_B, KC_C}, {KC_D, KC_E, KC_F}},
+    {{KC_1, KC_2, KC_3}, {KC_4, KC_5, KC_6}},
+    {{KC_F1, KC_F2, KC_F3}, {KC_F4, KC_F5, KC_F6}},
+};
+
+uint8_t keymap_layer_count(void) {
+    return sizeof(keymaps) / sizeof(keymaps[0]);
+}
+
+void send_string_with_delay(const char *str, uint8_t interval) {}
+
+/* EEPROM which counts how often it is read */
+static uint8_t eeprom[EEPROM_SIZE];
+static size_t  eeprom_reads;
+
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    eeprom_reads++;
+    return eeprom[(uintptr_t)addr];
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    eeprom[(uintptr_t)addr] = value;
+}
+}
+
+class DynamicKeymap : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        std::fill(std::begin(eeprom), std::end(eeprom), 0xFF);
+        dynamic_keymap_init();
+        dynamic_keymap_reset();
+        eeprom_reads = 0;
+    }
+
+    static uint16_t eeprom_keycode(uint8_t layer, uint8_t row, uint8_t col) {
+        uintptr_t address = (uintptr_t)dynamic_keymap_key_to_eeprom_address(layer, row, col);
+        return (eeprom[address] << 8) | eeprom[address + 1];
+    }
+};
+
+TEST_F(DynamicKeymap, cached_layers_are_read_without_the_eeprom) {
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 1, 2), KC_6);
+    EXPECT_EQ(eeprom_reads, 0);
+
+    EXPECT_EQ(dynamic_keymap_get_keycode(2, 1, 0), KC_F4);
+    EXPECT_EQ(dynamic_keymap_get_keycode(3, 0, 0), KC_TRNS);
+    EXPECT_GT(eeprom_reads, 0);
+}
+
+TEST_F(DynamicKeymap, init_loads_what_is_in_eeprom) {
+    uintptr_t address   = (uintptr_t)dynamic_keymap_key_to_eeprom_address(1, 0, 2);
+    eeprom[address]     = KC_X >> 8;
+    eeprom[address + 1] = KC_X & 0xFF;
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 2), KC_3);
+
+    dynamic_keymap_init();
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 2), KC_X);
+}
+
+TEST_F(DynamicKeymap, set_keycode_updates_eeprom_and_cache) {
+    dynamic_keymap_set_keycode(0, 1, 1, KC_Z);
+    dynamic_keymap_set_keycode(3, 1, 1, KC_Y);
+
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 1), KC_Z);
+    EXPECT_EQ(dynamic_keymap_get_keycode(3, 1, 1), KC_Y);
+    EXPECT_EQ(eeprom_keycode(0, 1, 1), KC_Z);
+}
+
+TEST_F(DynamicKeymap, set_buffer_updates_eeprom_and_cache) {
+    // Starts on the low byte of layer 0, row 1, col 2, and runs into layer 2 which is not cached
+    const uint16_t       offset = (MATRIX_COLS + 2) * 2 + 1;
+    std::vector<uint8_t> data;
+    for (uint16_t i = 0; i < 2 * MATRIX_ROWS * MATRIX_COLS * 2; i++) {
+        data.push_back(i);
+    }
+    dynamic_keymap_set_buffer(offset, data.size(), data.data());
+
+    for (uint8_t layer = 0; layer < 3; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                EXPECT_EQ(dynamic_keymap_get_keycode(layer, row, col), eeprom_keycode(layer, row, col)) << "layer " << +layer << " row " << +row << " col " << +col;
+            }
+        }
+    }
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 2), (KC_F & 0xFF00) | 0);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 0), 0x0102);
+}
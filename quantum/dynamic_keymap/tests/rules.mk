@@ -0,0 +1,5 @@
+dynamic_keymap_DEFS := -DMATRIX_ROWS=2 -DMATRIX_COLS=3 -DEEPROM_CUSTOM -DEEPROM_SIZE=1024 -DDYNAMIC_KEYMAP_ENABLE -DDYNAMIC_KEYMAP_LAYER_COUNT=4 -DDYNAMIC_KEYMAP_CACHE_LAYERS=2 -DSEND_STRING_ENABLE -Wno-int-to-pointer-cast
+
+dynamic_keymap_SRC := \
+	$(QUANTUM_PATH)/dynamic_keymap/tests/dynamic_keymap_tests.cpp \
+	$(QUANTUM_PATH)/dynamic_keymap.c
@@ -19,6 +19,9 @@
 #ifdef SPLIT_KEYBOARD
 #    include "split_util.h"
 #endif
+#ifdef KEYSTROKE_TRACE_ENABLE
+#    include "keystroke_trace.h"
+#endif
 
 // for memcpy
 #include <string.h>
@@ -149,6 +152,17 @@ static void encoder_exec_mapping(uint8_t index, bool clockwise) {
 }
 #endif // ENCODER_MAP_ENABLE
 
+static void encoder_exec(uint8_t index, bool clockwise) {
+#ifdef KEYSTROKE_TRACE_ENABLE
+    keystroke_trace_record_encoder(index, clockwise);
+#endif
+#ifdef ENCODER_MAP_ENABLE
+    encoder_exec_mapping(index, clockwise);
+#else  // ENCODER_MAP_ENABLE
+    encoder_update_kb(index, clockwise);
+#endif // ENCODER_MAP_ENABLE
+}
+
 static bool encoder_update(uint8_t index, uint8_t state) {
     bool    changed = false;
     uint8_t i       = index;
@@ -173,11 +187,7 @@ static bool encoder_update(uint8_t index, uint8_t state) {
 
             encoder_value[index]++;
             changed = true;
-#ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_COUNTER_CLOCKWISE);
         }
 
 #ifdef ENCODER_DEFAULT_POS
@@ -187,11 +197,7 @@ static bool encoder_update(uint8_t index, uint8_t state) {
 #endif
             encoder_value[index]--;
             changed = true;
-#ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_CLOCKWISE);
         }
         encoder_pulses[i] %= resolution;
 #ifdef ENCODER_DEFAULT_POS
@@ -230,21 +236,13 @@ void encoder_update_raw(uint8_t *slave_state) {
             delta--;
             encoder_value[index]++;
             changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_COUNTER_CLOCKWISE);
         }
         while (delta < 0) {
             delta++;
             encoder_value[index]--;
             changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_CLOCKWISE);
         }
     }
 
@@ -0,0 +1,43 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "key_event_queue.h"
+
+#define QUEUE_MASK (KEY_EVENT_QUEUE_SIZE - 1)
+
+void key_event_queue_init(key_event_queue_t *queue) {
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+bool key_event_queue_push(key_event_queue_t *queue, keyevent_t event) {
+    const uint8_t head = queue->head;
+    const uint8_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    if ((uint8_t)(head - tail) == KEY_EVENT_QUEUE_SIZE) {
+        return false;
+    }
+
+    queue->events[head & QUEUE_MASK] = event;
+    // Publish the event only once it has been written in full
+    __atomic_store_n(&queue->head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool key_event_queue_pop(key_event_queue_t *queue, keyevent_t *event) {
+    const uint8_t tail = queue->tail;
+    const uint8_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        return false;
+    }
+
+    *event = queue->events[tail & QUEUE_MASK];
+    // Hand the slot back to the producer only once the event has been copied out
+    __atomic_store_n(&queue->tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t key_event_queue_count(const key_event_queue_t *queue) {
+    return __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+}
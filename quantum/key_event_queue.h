@@ -0,0 +1,61 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+
+#ifndef KEY_EVENT_QUEUE_SIZE
+#    define KEY_EVENT_QUEUE_SIZE 32
+#endif
+
+#if KEY_EVENT_QUEUE_SIZE < 2 || KEY_EVENT_QUEUE_SIZE > 128 || (KEY_EVENT_QUEUE_SIZE & (KEY_EVENT_QUEUE_SIZE - 1)) != 0
+#    error "KEY_EVENT_QUEUE_SIZE must be a power of two between 2 and 128"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Lock-free queue of key events, for a single producer and a single consumer.
+ *
+ * The producer only ever writes `head` and the consumer only ever writes `tail`, so pushing from an interrupt handler
+ * or another thread while the main loop pops needs no critical section. Both indices count freely and wrap around.
+ */
+typedef struct {
+    keyevent_t events[KEY_EVENT_QUEUE_SIZE];
+    uint8_t    head;
+    uint8_t    tail;
+} key_event_queue_t;
+
+/**
+ * Empties the queue. Neither side may be using it at the time.
+ */
+void key_event_queue_init(key_event_queue_t *queue);
+
+/**
+ * Producer side: appends an event.
+ *
+ * @return false if the queue is full, in which case the event was not added
+ */
+bool key_event_queue_push(key_event_queue_t *queue, keyevent_t event);
+
+/**
+ * Consumer side: removes the oldest event.
+ *
+ * @param event[out] the event removed from the queue
+ * @return false if the queue was empty
+ */
+bool key_event_queue_pop(key_event_queue_t *queue, keyevent_t *event);
+
+/**
+ * @return the number of events waiting in the queue, as seen from either side
+ */
+uint8_t key_event_queue_count(const key_event_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
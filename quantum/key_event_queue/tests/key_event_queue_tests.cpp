@@ -0,0 +1,109 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+extern "C" {
+#include "key_event_queue.h"
+}
+
+static keyevent_t make_event(uint16_t n) {
+    return (keyevent_t){.key = {.col = (uint8_t)(n % MATRIX_COLS), .row = (uint8_t)(n / MATRIX_COLS % MATRIX_ROWS)}, .pressed = (n & 1) != 0, .time = n};
+}
+
+class KeyEventQueue : public ::testing::Test {
+   protected:
+    key_event_queue_t queue;
+
+    void SetUp() override {
+        key_event_queue_init(&queue);
+    }
+};
+
+TEST_F(KeyEventQueue, pops_in_push_order) {
+    keyevent_t event;
+
+    EXPECT_FALSE(key_event_queue_pop(&queue, &event));
+
+    for (uint16_t n = 1; n <= 5; n++) {
+        EXPECT_TRUE(key_event_queue_push(&queue, make_event(n)));
+    }
+    EXPECT_EQ(key_event_queue_count(&queue), 5);
+
+    for (uint16_t n = 1; n <= 5; n++) {
+        ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+        EXPECT_EQ(event.time, n);
+        EXPECT_TRUE(KEYEQ(event.key, make_event(n).key));
+        EXPECT_EQ(event.pressed, make_event(n).pressed);
+    }
+    EXPECT_FALSE(key_event_queue_pop(&queue, &event));
+    EXPECT_EQ(key_event_queue_count(&queue), 0);
+}
+
+TEST_F(KeyEventQueue, full_queue_rejects_events) {
+    keyevent_t event;
+
+    for (uint16_t n = 1; n <= KEY_EVENT_QUEUE_SIZE; n++) {
+        EXPECT_TRUE(key_event_queue_push(&queue, make_event(n)));
+    }
+    EXPECT_FALSE(key_event_queue_push(&queue, make_event(100)));
+    EXPECT_EQ(key_event_queue_count(&queue), KEY_EVENT_QUEUE_SIZE);
+
+    // Making room accepts events again, without disturbing those still queued
+    ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+    EXPECT_EQ(event.time, 1);
+    EXPECT_TRUE(key_event_queue_push(&queue, make_event(100)));
+
+    for (uint16_t n = 2; n <= KEY_EVENT_QUEUE_SIZE; n++) {
+        ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+        EXPECT_EQ(event.time, n);
+    }
+    ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+    EXPECT_EQ(event.time, 100);
+}
+
+TEST_F(KeyEventQueue, indices_wrap_around) {
+    keyevent_t event;
+
+    // Far more events than the 8-bit indices can count
+    for (uint16_t n = 1; n < 1000; n++) {
+        ASSERT_TRUE(key_event_queue_push(&queue, make_event(n)));
+        if (n % 3 == 0) {
+            ASSERT_TRUE(key_event_queue_push(&queue, make_event(n + 10000)));
+            ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+        }
+        ASSERT_TRUE(key_event_queue_pop(&queue, &event));
+        ASSERT_LE(key_event_queue_count(&queue), KEY_EVENT_QUEUE_SIZE);
+    }
+}
+
+TEST_F(KeyEventQueue, concurrent_producer_and_consumer) {
+    constexpr uint16_t count = 50000;
+
+    // Stands in for the scanning interrupt, running at the same time as the main loop
+    std::thread producer([&] {
+        for (uint16_t n = 1; n <= count; n++) {
+            while (!key_event_queue_push(&queue, make_event(n))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint16_t expected = 1;
+    while (expected <= count) {
+        keyevent_t event;
+        if (key_event_queue_pop(&queue, &event)) {
+            ASSERT_EQ(event.time, expected);
+            ASSERT_TRUE(KEYEQ(event.key, make_event(expected).key));
+            ASSERT_EQ(event.pressed, make_event(expected).pressed);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(key_event_queue_count(&queue), 0);
+}
@@ -0,0 +1,5 @@
+key_event_queue_DEFS := -DMATRIX_ROWS=8 -DMATRIX_COLS=8 -DKEY_EVENT_QUEUE_SIZE=8
+
+key_event_queue_SRC := \
+	$(QUANTUM_PATH)/key_event_queue/tests/key_event_queue_tests.cpp \
+	$(QUANTUM_PATH)/key_event_queue.c
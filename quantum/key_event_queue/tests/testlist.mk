@@ -0,0 +1 @@
+TEST_LIST += key_event_queue
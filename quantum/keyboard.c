@@ -111,6 +111,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef CAPS_WORD_ENABLE
 #    include "caps_word.h"
 #endif
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+#ifdef KEYSTROKE_TRACE_ENABLE
+#    include "keystroke_trace.h"
+#endif
+#ifdef SOF_SYNC_ENABLE
+#    include "sof_sync.h"
+#endif
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+#    include "background_matrix_scan.h"
+#endif
+#ifdef KEYMAP_CACHE_ENABLE
+#    include "keymap_cache.h"
+#endif
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
+#include "profile.h"
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -361,6 +380,9 @@ void keyboard_init(void) {
 #ifdef VIA_ENABLE
     via_init();
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_init();
+#endif
 #ifdef SPLIT_KEYBOARD
     split_pre_init();
 #endif
@@ -415,6 +437,19 @@ void keyboard_init(void) {
     debug_enable = true;
 #endif
 
+#if defined(PROFILE_ENABLE) || defined(LATENCY_TRACE_ENABLE)
+    profile_init();
+#endif
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_init();
+#endif
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+    background_matrix_scan_init();
+#endif
+#ifdef KEYSTROKE_TRACE_ENABLE
+    keystroke_trace_init();
+#endif
+
     keyboard_post_init_kb(); /* Always keep this last */
 }
 
@@ -452,6 +487,46 @@ static inline void generate_tick_event(void) {
  * @return true Matrix did change
  * @return false Matrix didn't change
  */
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+/** \brief Processes the key events queued by the background matrix scan
+ *
+ * Each event keeps the time of the scan which detected it, rather than the time it is processed at.
+ */
+static bool matrix_task(void) {
+    // Only runs the matrix_scan_* callbacks, the keys have already been scanned
+    matrix_scan();
+
+    const bool process_keypress = should_process_keypress();
+    bool       matrix_changed   = false;
+    keyevent_t event;
+
+    while (background_matrix_scan_get_event(&event)) {
+        matrix_changed = true;
+
+        if (process_keypress) {
+#    ifdef LATENCY_TRACE_ENABLE
+            latency_trace_key_detected(event);
+#    endif
+#    ifdef KEYSTROKE_TRACE_ENABLE
+            keystroke_trace_record_key(event);
+#    endif
+            action_exec(event);
+        }
+
+        switch_events(event.key.row, event.key.col, event.pressed);
+    }
+
+    matrix_scan_perf_task();
+
+    if (!matrix_changed) {
+        generate_tick_event();
+    } else if (debug_config.matrix) {
+        matrix_print();
+    }
+
+    return matrix_changed;
+}
+#else
 static bool matrix_task(void) {
     static matrix_row_t matrix_previous[MATRIX_ROWS];
 
@@ -490,7 +565,14 @@ static bool matrix_task(void) {
                 const bool key_pressed = current_row & col_mask;
 
                 if (process_keypress) {
-                    action_exec(MAKE_KEYEVENT(row, col, key_pressed));
+                    const keyevent_t event = MAKE_KEYEVENT(row, col, key_pressed);
+#ifdef LATENCY_TRACE_ENABLE
+                    latency_trace_key_detected(event);
+#endif
+#ifdef KEYSTROKE_TRACE_ENABLE
+                    keystroke_trace_record_key(event);
+#endif
+                    action_exec(event);
                 }
 
                 switch_events(row, col, key_pressed);
@@ -502,6 +584,7 @@ static bool matrix_task(void) {
 
     return matrix_changed;
 }
+#endif
 
 /** \brief Tasks previously located in matrix_scan_quantum
  *
@@ -534,141 +617,319 @@ void quantum_task(void) {
 #endif
 
 #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
-    music_task();
+    PROFILE_CALL(music_task);
 #endif
 
 #ifdef KEY_OVERRIDE_ENABLE
-    key_override_task();
+    PROFILE_CALL(key_override_task);
 #endif
 
 #ifdef SEQUENCER_ENABLE
-    sequencer_task();
+    PROFILE_CALL(sequencer_task);
 #endif
 
 #ifdef TAP_DANCE_ENABLE
-    tap_dance_task();
+    PROFILE_CALL(tap_dance_task);
 #endif
 
 #ifdef COMBO_ENABLE
-    combo_task();
+    PROFILE_CALL(combo_task);
+#endif
+
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_COUNT)
+    PROFILE_CALL(leader_task);
 #endif
 
 #ifdef WPM_ENABLE
-    decay_wpm();
+    PROFILE_CALL(decay_wpm);
 #endif
 
 #ifdef HAPTIC_ENABLE
-    haptic_task();
+    PROFILE_CALL(haptic_task);
 #endif
 
 #ifdef DIP_SWITCH_ENABLE
-    dip_switch_read(false);
+    PROFILE_CALL(dip_switch_read, false);
 #endif
 
 #ifdef AUTO_SHIFT_ENABLE
-    autoshift_matrix_scan();
+    PROFILE_CALL(autoshift_matrix_scan);
 #endif
 
 #ifdef CAPS_WORD_ENABLE
-    caps_word_task();
+    PROFILE_CALL(caps_word_task);
 #endif
 
 #ifdef SECURE_ENABLE
-    secure_task();
+    PROFILE_CALL(secure_task);
 #endif
 }
 
-/** \brief Main task that is repeatedly called as fast as possible. */
-void keyboard_task(void) {
-    const bool matrix_changed = matrix_task();
-    if (matrix_changed) {
-        last_matrix_activity_trigger();
-    }
-
-    quantum_task();
-
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
-#endif
-
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
-#endif
-
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
-#endif
-
 #ifdef ENCODER_ENABLE
-    const bool encoders_changed = encoder_read();
+static bool encoders_changed = false;
+
+static void encoder_task(void) {
+    encoders_changed = encoder_read();
     if (encoders_changed) {
         last_encoder_activity_trigger();
     }
+}
 #endif
 
+#ifdef VELOCIKEY_ENABLE
+static void velocikey_task(void) {
+    if (velocikey_enabled()) {
+        velocikey_decelerate();
+    }
+}
+#endif
+
+/* Whether the matrix changed on the current main loop iteration, for the tasks below */
+static bool keyboard_matrix_changed = false;
+
 #ifdef OLED_ENABLE
-    oled_task();
 #    if OLED_TIMEOUT > 0
+static void oled_wake_task(void) {
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
-    if (matrix_changed || encoders_changed) oled_on();
+    if (keyboard_matrix_changed || encoders_changed) oled_on();
 #        else
-    if (matrix_changed) oled_on();
+    if (keyboard_matrix_changed) oled_on();
 #        endif
+}
 #    endif
 #endif
 
 #ifdef ST7565_ENABLE
-    st7565_task();
 #    if ST7565_TIMEOUT > 0
+static void st7565_wake_task(void) {
     // Wake up display if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
-    if (matrix_changed || encoders_changed) st7565_on();
+    if (keyboard_matrix_changed || encoders_changed) st7565_on();
 #        else
-    if (matrix_changed) st7565_on();
+    if (keyboard_matrix_changed) st7565_on();
 #        endif
+}
 #    endif
 #endif
 
-#ifdef MOUSEKEY_ENABLE
+#ifdef TASK_SCHEDULER_ENABLE
+#    ifndef TASK_SCHEDULER_LIGHTING_PERIOD
+#        define TASK_SCHEDULER_LIGHTING_PERIOD 1
+#    endif
+
+#    ifndef TASK_SCHEDULER_DISPLAY_PERIOD
+#        define TASK_SCHEDULER_DISPLAY_PERIOD 5
+#    endif
+
+#    ifdef TASK_SCHEDULER_NAMES
+#        define KEYBOARD_TASK_NAME(func) .name = #func,
+#    else
+#        define KEYBOARD_TASK_NAME(func)
+#    endif
+
+#    define KEYBOARD_TASK(func, task_period, task_priority) \
+    { KEYBOARD_TASK_NAME(func).task = func, .next_deadline = NULL, .period = (task_period), .priority = (task_priority) }
+#    define KEYBOARD_TASK_WITH_DEADLINE(func, deadline_func, task_period, task_priority) \
+    { KEYBOARD_TASK_NAME(func).task = func, .next_deadline = deadline_func, .period = (task_period), .priority = (task_priority) }
+
+/**
+ * @brief Tasks executed after the matrix scan and key processing, in order.
+ */
+static const scheduled_task_t keyboard_tasks[] = {
+#    ifdef KEYMAP_CACHE_ENABLE
+    KEYBOARD_TASK(keymap_cache_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    if defined(RGBLIGHT_ENABLE)
+    KEYBOARD_TASK(rgblight_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_PRIORITY_LOW),
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    KEYBOARD_TASK_WITH_DEADLINE(led_matrix_task, led_matrix_next_deadline, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_PRIORITY_LOW),
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    KEYBOARD_TASK_WITH_DEADLINE(rgb_matrix_task, rgb_matrix_next_deadline, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_PRIORITY_LOW),
+#    endif
+#    if defined(BACKLIGHT_ENABLE)
+#        if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    KEYBOARD_TASK(backlight_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_PRIORITY_LOW),
+#        endif
+#    endif
+#    ifdef ENCODER_ENABLE
+    KEYBOARD_TASK(encoder_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef OLED_ENABLE
+    KEYBOARD_TASK(oled_task, TASK_SCHEDULER_DISPLAY_PERIOD, TASK_PRIORITY_LOW),
+#        if OLED_TIMEOUT > 0
+    KEYBOARD_TASK(oled_wake_task, 0, TASK_PRIORITY_HIGH),
+#        endif
+#    endif
+#    ifdef ST7565_ENABLE
+    KEYBOARD_TASK(st7565_task, TASK_SCHEDULER_DISPLAY_PERIOD, TASK_PRIORITY_LOW),
+#        if ST7565_TIMEOUT > 0
+    KEYBOARD_TASK(st7565_wake_task, 0, TASK_PRIORITY_HIGH),
+#        endif
+#    endif
+#    ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
-#endif
+    KEYBOARD_TASK(mousekey_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef PS2_MOUSE_ENABLE
+    KEYBOARD_TASK(ps2_mouse_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+    KEYBOARD_TASK(pointing_device_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef MIDI_ENABLE
+    KEYBOARD_TASK(midi_task, 0, TASK_PRIORITY_NORMAL),
+#    endif
+#    ifdef VELOCIKEY_ENABLE
+    KEYBOARD_TASK(velocikey_task, 0, TASK_PRIORITY_NORMAL),
+#    endif
+#    ifdef JOYSTICK_ENABLE
+    KEYBOARD_TASK(joystick_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef DIGITIZER_ENABLE
+    KEYBOARD_TASK(digitizer_task, 0, TASK_PRIORITY_HIGH),
+#    endif
+#    ifdef PROGRAMMABLE_BUTTON_ENABLE
+    KEYBOARD_TASK(programmable_button_send, 0, TASK_PRIORITY_HIGH),
+#    endif
+    KEYBOARD_TASK(led_task, 0, TASK_PRIORITY_NORMAL),
+};
 
-#ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
-#endif
+#    define KEYBOARD_TASK_COUNT (sizeof(keyboard_tasks) / sizeof(keyboard_tasks[0]))
 
-#ifdef POINTING_DEVICE_ENABLE
-    pointing_device_task();
-#endif
+static scheduled_task_state_t keyboard_task_states[KEYBOARD_TASK_COUNT];
 
-#ifdef MIDI_ENABLE
-    midi_task();
-#endif
+uint8_t get_keyboard_task_count(void) {
+    return KEYBOARD_TASK_COUNT;
+}
 
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled()) {
-        velocikey_decelerate();
+const scheduled_task_t *get_keyboard_task(uint8_t index) {
+    return index < KEYBOARD_TASK_COUNT ? &keyboard_tasks[index] : NULL;
+}
+
+const scheduled_task_state_t *get_keyboard_task_state(uint8_t index) {
+    return index < KEYBOARD_TASK_COUNT ? &keyboard_task_states[index] : NULL;
+}
+
+uint32_t keyboard_task_next_deadline(void) {
+    return task_scheduler_next_deadline(keyboard_tasks, keyboard_task_states, KEYBOARD_TASK_COUNT);
+}
+
+#    if defined(DEBUG_TASK_SCHEDULER) && defined(CONSOLE_ENABLE)
+static void task_scheduler_perf_task(void) {
+    static uint32_t stats_timer = 0;
+
+    if (timer_elapsed32(stats_timer) >= 1000) {
+        task_scheduler_print_stats(keyboard_tasks, keyboard_task_states, KEYBOARD_TASK_COUNT);
+        task_scheduler_reset_stats(keyboard_task_states, KEYBOARD_TASK_COUNT);
+        stats_timer = timer_read32();
     }
+}
+#    else
+#        define task_scheduler_perf_task()
+#    endif
 #endif
 
-#ifdef JOYSTICK_ENABLE
-    joystick_task();
+/** \brief Main task that is repeatedly called as fast as possible. */
+void keyboard_task(void) {
+    const bool matrix_changed = PROFILE_CALL_BOOL(matrix_task);
+    if (matrix_changed) {
+        last_matrix_activity_trigger();
+    }
+    keyboard_matrix_changed = matrix_changed;
+
+    PROFILE_CALL(quantum_task);
+
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_run(keyboard_tasks, keyboard_task_states, KEYBOARD_TASK_COUNT, matrix_changed);
+    task_scheduler_perf_task();
+#else
+#    ifdef KEYMAP_CACHE_ENABLE
+    PROFILE_CALL(keymap_cache_task);
+#    endif
+
+#    if defined(RGBLIGHT_ENABLE)
+    PROFILE_CALL(rgblight_task);
+#    endif
+
+#    ifdef LED_MATRIX_ENABLE
+    PROFILE_CALL(led_matrix_task);
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    PROFILE_CALL(rgb_matrix_task);
+#    endif
+
+#    if defined(BACKLIGHT_ENABLE)
+#        if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    PROFILE_CALL(backlight_task);
+#        endif
+#    endif
+
+#    ifdef ENCODER_ENABLE
+    PROFILE_CALL(encoder_task);
+#    endif
+
+#    ifdef OLED_ENABLE
+    PROFILE_CALL(oled_task);
+#        if OLED_TIMEOUT > 0
+    oled_wake_task();
+#        endif
+#    endif
+
+#    ifdef ST7565_ENABLE
+    PROFILE_CALL(st7565_task);
+#        if ST7565_TIMEOUT > 0
+    st7565_wake_task();
+#        endif
+#    endif
+
+#    ifdef MOUSEKEY_ENABLE
+    // mousekey repeat & acceleration
+    PROFILE_CALL(mousekey_task);
+#    endif
+
+#    ifdef PS2_MOUSE_ENABLE
+    PROFILE_CALL(ps2_mouse_task);
+#    endif
+
+#    ifdef POINTING_DEVICE_ENABLE
+    PROFILE_CALL(pointing_device_task);
+#    endif
+
+#    ifdef MIDI_ENABLE
+    PROFILE_CALL(midi_task);
+#    endif
+
+#    ifdef VELOCIKEY_ENABLE
+    PROFILE_CALL(velocikey_task);
+#    endif
+
+#    ifdef JOYSTICK_ENABLE
+    PROFILE_CALL(joystick_task);
+#    endif
+
+#    ifdef DIGITIZER_ENABLE
+    PROFILE_CALL(digitizer_task);
+#    endif
+
+#    ifdef PROGRAMMABLE_BUTTON_ENABLE
+    PROFILE_CALL(programmable_button_send);
+#    endif
+
+    PROFILE_CALL(led_task);
 #endif
 
-#ifdef DIGITIZER_ENABLE
-    digitizer_task();
+#ifdef PROFILE_ENABLE
+    profile_task();
 #endif
 
-#ifdef PROGRAMMABLE_BUTTON_ENABLE
-    programmable_button_send();
+#ifdef LATENCY_TRACE_ENABLE
+    latency_trace_task();
 #endif
 
-    led_task();
+#ifdef SOF_SYNC_ENABLE
+    sof_sync_task();
+#endif
 }
@@ -0,0 +1,49 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keymap_cache.h"
+#include "action_layer.h"
+#include "matrix.h"
+
+#ifdef NO_ACTION_LAYER
+#    error "The keymap cache requires action layers, disable NO_ACTION_LAYER or KEYMAP_CACHE_ENABLE"
+#endif
+
+// Highest active layer where each key is not transparent, for layer_state | default_layer_state == cached_layers
+static uint8_t       resolved_layers[MATRIX_ROWS][MATRIX_COLS];
+static layer_state_t cached_layers;
+// Rows below this one are up to date
+static uint8_t rows_ready;
+
+void keymap_cache_init(void) {
+    keymap_cache_invalidate();
+}
+
+void keymap_cache_invalidate(void) {
+    rows_ready = 0;
+}
+
+void keymap_cache_task(void) {
+    const layer_state_t layers = layer_state | default_layer_state;
+    if (layers != cached_layers) {
+        cached_layers = layers;
+        rows_ready    = 0;
+    }
+    if (rows_ready >= MATRIX_ROWS) {
+        return;
+    }
+
+    // Only one row per iteration, so that switching layers does not hold up the next scan
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        resolved_layers[rows_ready][col] = layer_switch_find_layer((keypos_t){.row = rows_ready, .col = col}, layers);
+    }
+    rows_ready++;
+}
+
+bool keymap_cache_get_layer(keypos_t key, uint8_t *layer) {
+    if (key.row >= rows_ready || key.col >= MATRIX_COLS || (layer_state | default_layer_state) != cached_layers) {
+        return false;
+    }
+    *layer = resolved_layers[key.row][key.col];
+    return true;
+}
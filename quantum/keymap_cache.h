@@ -0,0 +1,41 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Empties the cache, invoked by keyboard_init().
+ */
+void keymap_cache_init(void);
+
+/**
+ * Rebuilds one row of the cache when the layer state has changed, invoked on every main loop iteration.
+ */
+void keymap_cache_task(void);
+
+/**
+ * Throws away every cached entry. Must be called whenever the contents of the keymap change, for example when a
+ * dynamic keymap is written.
+ */
+void keymap_cache_invalidate(void);
+
+/**
+ * Looks up the layer a key resolves to under the current layer state.
+ *
+ * @param key the matrix position of the key
+ * @param layer[out] the highest active layer where the key is not transparent
+ * @return false if the key is not in the cache, in which case the layers have to be searched
+ */
+bool keymap_cache_get_layer(keypos_t key, uint8_t *layer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,174 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "keystroke_trace.h"
+#include "timer.h"
+
+// Number of events kept, the oldest ones are overwritten once it is full
+#ifndef KEYSTROKE_TRACE_LENGTH
+#    define KEYSTROKE_TRACE_LENGTH 128
+#endif
+
+#if KEYSTROKE_TRACE_LENGTH < 1 || KEYSTROKE_TRACE_LENGTH > UINT16_MAX
+#    error "KEYSTROKE_TRACE_LENGTH must be between 1 and 65535"
+#endif
+
+_Static_assert(sizeof(keystroke_trace_event_t) == 8, "keystroke_trace_event_t must stay 8 bytes, it is the dump format");
+
+static keystroke_trace_event_t events[KEYSTROKE_TRACE_LENGTH];
+static uint16_t                events_head  = 0;
+static uint16_t                events_count = 0;
+static uint32_t                dropped      = 0;
+static uint32_t                last_time    = 0;
+static bool                    recording    = false;
+static uint8_t                 last_buttons = 0;
+
+void keystroke_trace_init(void) {
+    keystroke_trace_clear();
+    keystroke_trace_start();
+}
+
+static void record(keystroke_trace_type_t type, const uint8_t *payload, uint8_t length) {
+    if (!recording) {
+        return;
+    }
+
+    const uint32_t now   = timer_read32();
+    const uint32_t delta = TIMER_DIFF_32(now, last_time);
+    last_time            = now;
+
+    keystroke_trace_event_t *event = &events[events_head];
+    event->delta                   = delta > UINT16_MAX ? UINT16_MAX : delta;
+    event->type                    = type;
+    memset(event->raw, 0, sizeof(event->raw));
+    memcpy(event->raw, payload, length);
+
+    events_head = events_head + 1 == KEYSTROKE_TRACE_LENGTH ? 0 : events_head + 1;
+    if (events_count < KEYSTROKE_TRACE_LENGTH) {
+        events_count++;
+    } else {
+        dropped++;
+    }
+}
+
+void keystroke_trace_record_key(keyevent_t event) {
+    const uint8_t payload[] = {event.key.row, event.key.col, event.pressed};
+    record(KEYSTROKE_TRACE_KEY, payload, sizeof(payload));
+}
+
+void keystroke_trace_record_encoder(uint8_t index, bool clockwise) {
+    const uint8_t payload[] = {index, clockwise};
+    record(KEYSTROKE_TRACE_ENCODER, payload, sizeof(payload));
+}
+
+static int8_t clamp_motion(int16_t value) {
+    return value < INT8_MIN ? INT8_MIN : value > INT8_MAX ? INT8_MAX : value;
+}
+
+void keystroke_trace_record_pointing(report_mouse_t report) {
+    if (!report.x && !report.y && !report.h && !report.v && report.buttons == last_buttons) {
+        return;
+    }
+    last_buttons = report.buttons;
+
+    // Extended reports are clamped, the trace keeps the 8 bit range of the boot protocol
+    const uint8_t payload[] = {clamp_motion(report.x), clamp_motion(report.y), report.h, report.v, report.buttons};
+    record(KEYSTROKE_TRACE_POINTING, payload, sizeof(payload));
+}
+
+void keystroke_trace_start(void) {
+    if (!recording) {
+        recording = true;
+        last_time = timer_read32();
+    }
+}
+
+void keystroke_trace_stop(void) {
+    recording = false;
+}
+
+bool keystroke_trace_is_recording(void) {
+    return recording;
+}
+
+void keystroke_trace_clear(void) {
+    events_head  = 0;
+    events_count = 0;
+    dropped      = 0;
+    last_time    = timer_read32();
+}
+
+uint16_t keystroke_trace_count(void) {
+    return events_count;
+}
+
+uint32_t keystroke_trace_dropped(void) {
+    return dropped;
+}
+
+bool keystroke_trace_get(uint16_t index, keystroke_trace_event_t *event) {
+    if (index >= events_count) {
+        return false;
+    }
+
+    // The oldest event sits right after the newest one once the trace has wrapped around
+    uint32_t position = (uint32_t)events_head + KEYSTROKE_TRACE_LENGTH - events_count + index;
+    if (position >= KEYSTROKE_TRACE_LENGTH) {
+        position -= KEYSTROKE_TRACE_LENGTH;
+    }
+    *event = events[position];
+    return true;
+}
+
+static void write_u16(uint8_t *data, uint16_t value) {
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+static void write_u32(uint8_t *data, uint32_t value) {
+    write_u16(data, value & 0xFFFF);
+    write_u16(data + 2, value >> 16);
+}
+
+bool keystroke_trace_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 12 || data[0] != KEYSTROKE_TRACE_RAW_HID_ID) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case KEYSTROKE_TRACE_CMD_INFO:
+            write_u16(&data[2], events_count);
+            write_u16(&data[4], KEYSTROKE_TRACE_LENGTH);
+            write_u32(&data[6], dropped);
+            data[10] = recording;
+            data[11] = sizeof(keystroke_trace_event_t);
+            break;
+        case KEYSTROKE_TRACE_CMD_READ: {
+            // As many events as fit in the reply, starting at the requested one
+            uint16_t index = data[2] | (data[3] << 8);
+            uint8_t  count = 0;
+            for (uint8_t offset = 5; offset + sizeof(keystroke_trace_event_t) <= length; offset += sizeof(keystroke_trace_event_t)) {
+                if (!keystroke_trace_get(index++, (keystroke_trace_event_t *)&data[offset])) {
+                    break;
+                }
+                count++;
+            }
+            data[4] = count;
+            break;
+        }
+        case KEYSTROKE_TRACE_CMD_CLEAR:
+            keystroke_trace_clear();
+            break;
+        case KEYSTROKE_TRACE_CMD_START:
+            keystroke_trace_start();
+            break;
+        case KEYSTROKE_TRACE_CMD_STOP:
+            keystroke_trace_stop();
+            break;
+        default:
+            data[1] = 0xFF;
+            break;
+    }
+    return true;
+}
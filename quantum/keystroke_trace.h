@@ -0,0 +1,121 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+#include "report.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @enum The source of a recorded input event.
+ */
+typedef enum {
+    KEYSTROKE_TRACE_KEY,
+    KEYSTROKE_TRACE_ENCODER,
+    KEYSTROKE_TRACE_POINTING,
+} keystroke_trace_type_t;
+
+/**
+ * One recorded input event, 8 bytes in little endian byte order. This is also the format of the raw HID dump and of
+ * trace files, which are simply these records back to back, oldest first.
+ */
+typedef struct __attribute__((packed)) {
+    // Milliseconds since the previous event, saturating at 65535
+    uint16_t delta;
+    // keystroke_trace_type_t
+    uint8_t type;
+    union {
+        struct {
+            uint8_t row;
+            uint8_t col;
+            uint8_t pressed;
+        } key;
+        struct {
+            uint8_t index;
+            uint8_t clockwise;
+        } encoder;
+        struct {
+            int8_t  x;
+            int8_t  y;
+            int8_t  h;
+            int8_t  v;
+            uint8_t buttons;
+        } pointing;
+        uint8_t raw[5];
+    };
+} keystroke_trace_event_t;
+
+/* Command byte of the raw HID requests, which follow the layout described in docs/faq_debug.md */
+#ifndef KEYSTROKE_TRACE_RAW_HID_ID
+#    define KEYSTROKE_TRACE_RAW_HID_ID 0x54
+#endif
+
+typedef enum {
+    KEYSTROKE_TRACE_CMD_INFO,
+    KEYSTROKE_TRACE_CMD_READ,
+    KEYSTROKE_TRACE_CMD_CLEAR,
+    KEYSTROKE_TRACE_CMD_START,
+    KEYSTROKE_TRACE_CMD_STOP,
+} keystroke_trace_command_t;
+
+/**
+ * Empties the trace and starts recording, invoked by keyboard_init().
+ */
+void keystroke_trace_init(void);
+
+/**
+ * Records a debounced key change detected by matrix_task().
+ */
+void keystroke_trace_record_key(keyevent_t event);
+
+/**
+ * Records one step of an encoder.
+ */
+void keystroke_trace_record_encoder(uint8_t index, bool clockwise);
+
+/**
+ * Records the motion and buttons read from the pointing device driver. Reports without motion are only recorded when
+ * the buttons change.
+ */
+void keystroke_trace_record_pointing(report_mouse_t report);
+
+void keystroke_trace_start(void);
+void keystroke_trace_stop(void);
+bool keystroke_trace_is_recording(void);
+void keystroke_trace_clear(void);
+
+/**
+ * @return the number of events in the trace
+ */
+uint16_t keystroke_trace_count(void);
+
+/**
+ * @return the number of events which were overwritten because the trace was full
+ */
+uint32_t keystroke_trace_dropped(void);
+
+/**
+ * Reads an event from the trace.
+ *
+ * @param index position of the event, 0 being the oldest one
+ * @param event[out] the event
+ * @return false if there is no event at that position
+ */
+bool keystroke_trace_get(uint16_t index, keystroke_trace_event_t *event);
+
+/**
+ * Handles a raw HID request for the trace, replying in the same buffer.
+ *
+ * @return false if the request is not for the trace, in which case the buffer is left untouched
+ */
+bool keystroke_trace_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,333 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "latency_trace.h"
+#include "profile.h"
+#include "quantum.h"
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+#    include "atomic_util.h"
+#endif
+
+#ifndef LATENCY_TRACE_PENDING
+#    define LATENCY_TRACE_PENDING 8
+#endif
+
+// Events whose change never makes it into a report, such as keys swallowed by a macro, are dropped after this long
+#ifndef LATENCY_TRACE_TIMEOUT
+#    define LATENCY_TRACE_TIMEOUT 1000
+#endif
+
+#ifndef LATENCY_TRACE_PRINT_INTERVAL
+#    define LATENCY_TRACE_PRINT_INTERVAL 10000
+#endif
+
+/* Stages are timed with the profile counter where it counts CPU cycles. Elsewhere the millisecond timer is the finest
+ * clock at hand, the test platform's profile counter follows the host's clock rather than the simulated one. */
+#if defined(PROTOCOL_CHIBIOS) && defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#    define LATENCY_TIMESTAMP() profile_timestamp()
+#    define LATENCY_TICKS_TO_US(ticks) ((ticks) / (CPU_CLOCK / 1000000))
+#    define LATENCY_RESOLUTION_US 1
+#else
+#    define LATENCY_TIMESTAMP() timer_read32()
+#    define LATENCY_TICKS_TO_US(ticks) ((ticks)*1000)
+#    define LATENCY_RESOLUTION_US 1000
+#endif
+
+// Bucket 0 holds latencies below 2^LATENCY_TRACE_BUCKET_SHIFT microseconds
+#define LATENCY_TRACE_BUCKET_SHIFT 5
+
+typedef enum {
+    PENDING_FREE,
+    PENDING_DETECTED,
+    PENDING_RESOLVED,
+} pending_state_t;
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    bool     combined;
+    uint8_t  state;
+    uint8_t  type;
+    // What the event adds to or removes from the keyboard report
+    uint8_t  code;
+    uint8_t  mods;
+    uint32_t debounce;
+    uint32_t detect_time;
+    uint32_t resolve_time;
+} pending_event_t;
+
+static pending_event_t     pending[LATENCY_TRACE_PENDING];
+static latency_histogram_t histograms[LATENCY_EVENT_TYPE_COUNT][LATENCY_STAGE_COUNT];
+static bool                histograms_updated = false;
+
+// Written by the matrix scan, which runs off the main loop with background matrix scanning
+static volatile bool     raw_change_pending = false;
+static volatile bool     raw_change_seen    = false;
+static volatile uint32_t raw_change_time    = 0;
+
+static report_keyboard_t last_report;
+
+static void histogram_add(latency_event_type_t type, latency_stage_t stage, uint32_t latency) {
+    latency_histogram_t *histogram = &histograms[type][stage];
+    uint8_t              bucket    = 0;
+
+    while (latency >> (bucket + LATENCY_TRACE_BUCKET_SHIFT) && bucket < LATENCY_TRACE_BUCKETS - 1) {
+        ++bucket;
+    }
+
+    // Saturate rather than wrap, the ratios between buckets stay meaningful
+    if (histogram->count == UINT16_MAX) {
+        return;
+    }
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total += latency;
+    if (latency > histogram->max) {
+        histogram->max = latency;
+    }
+    histograms_updated = true;
+}
+
+static void expire_pending(uint32_t now) {
+    for (uint8_t i = 0; i < LATENCY_TRACE_PENDING; ++i) {
+        if (pending[i].state != PENDING_FREE && LATENCY_TICKS_TO_US(now - pending[i].detect_time) > LATENCY_TRACE_TIMEOUT * 1000UL) {
+            pending[i].state = PENDING_FREE;
+        }
+    }
+}
+
+void latency_trace_matrix_changed(void) {
+    // Only the first raw change counts, later ones are the switch bouncing
+    if (!raw_change_pending) {
+        raw_change_pending = true;
+        raw_change_seen    = true;
+        raw_change_time    = LATENCY_TIMESTAMP();
+    }
+}
+
+void latency_trace_key_detected(keyevent_t event) {
+    const uint32_t   now   = LATENCY_TIMESTAMP();
+    pending_event_t *entry = NULL;
+
+    expire_pending(now);
+
+    for (uint8_t i = 0; i < LATENCY_TRACE_PENDING; ++i) {
+        if (pending[i].state == PENDING_FREE) {
+            entry = &pending[i];
+            break;
+        }
+        // Remember the oldest entry in case it has to be evicted
+        if (!entry || now - pending[i].detect_time > now - entry->detect_time) {
+            entry = &pending[i];
+        }
+    }
+
+    entry->key          = event.key;
+    entry->pressed      = event.pressed;
+    entry->combined     = false;
+    entry->state        = PENDING_DETECTED;
+    entry->type         = LATENCY_EVENT_PLAIN;
+    entry->code         = KC_NO;
+    entry->mods         = 0;
+    entry->detect_time  = now;
+    entry->resolve_time = 0;
+
+    bool     seen;
+    uint32_t raw_time;
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+    ATOMIC_BLOCK_FORCEON
+#endif
+    {
+        seen     = raw_change_seen;
+        raw_time = raw_change_time;
+        // Keys detected during the same scan share the raw change
+        raw_change_pending = false;
+    }
+    entry->debounce = seen ? LATENCY_TICKS_TO_US(now - raw_time) : UINT32_MAX;
+}
+
+void latency_trace_combo_key(keyevent_t event) {
+    for (uint8_t i = 0; i < LATENCY_TRACE_PENDING; ++i) {
+        pending_event_t *entry = &pending[i];
+        if (entry->state == PENDING_DETECTED && entry->pressed == event.pressed && KEYEQ(entry->key, event.key)) {
+            entry->combined = true;
+            break;
+        }
+    }
+}
+
+// Modifier keycodes show up in the report's mods rather than its keys
+static void add_report_code(uint8_t keycode, uint8_t *code, uint8_t *mods) {
+    if (IS_MOD(keycode)) {
+        *mods |= MOD_BIT(keycode);
+    } else {
+        *code = keycode;
+    }
+}
+
+/* Works out what the event changes in the keyboard report. Events that change nothing there, like layer keys, are not
+ * traced. */
+static bool classify(keyrecord_t *record, action_t action, latency_event_type_t *type, uint8_t *code, uint8_t *mods) {
+    *type = IS_COMBOEVENT(record->event) ? LATENCY_EVENT_COMBO : LATENCY_EVENT_PLAIN;
+    *code = KC_NO;
+    *mods = 0;
+
+#ifdef TAP_DANCE_ENABLE
+    uint16_t keycode = get_record_keycode(record, false);
+    if (keycode >= QK_TAP_DANCE && keycode <= QK_TAP_DANCE_MAX) {
+        // The dance sends whatever its callbacks register, which is not known up front
+        *type = LATENCY_EVENT_TAP_DANCE;
+        return true;
+    }
+#endif
+
+    switch (action.kind.id) {
+        case ACT_LMODS:
+        case ACT_RMODS:
+            *mods = action.kind.id == ACT_LMODS ? action.key.mods : action.key.mods << 4;
+            add_report_code(action.key.code, code, mods);
+            break;
+        case ACT_LMODS_TAP:
+        case ACT_RMODS_TAP:
+            if (*type == LATENCY_EVENT_PLAIN) {
+                *type = LATENCY_EVENT_MOD_TAP;
+            }
+            if (record->tap.count > 0) {
+                add_report_code(action.key.code, code, mods);
+            } else {
+                *mods = action.kind.id == ACT_LMODS_TAP ? action.key.mods : action.key.mods << 4;
+            }
+            break;
+        case ACT_LAYER_TAP:
+        case ACT_LAYER_TAP_EXT:
+            // Holding a layer tap key, or any of the layer operations, only changes the layer state
+            if (*type == LATENCY_EVENT_PLAIN) {
+                *type = LATENCY_EVENT_MOD_TAP;
+            }
+            if (record->tap.count > 0 && action.layer_tap.code < OP_TAP_TOGGLE) {
+                add_report_code(action.layer_tap.code, code, mods);
+            }
+            break;
+        default:
+            break;
+    }
+    return *code != KC_NO || *mods != 0;
+}
+
+void latency_trace_key_resolved(keyrecord_t *record, action_t action) {
+    latency_event_type_t type;
+    uint8_t              code, mods;
+    const bool           traced = classify(record, action, &type, &code, &mods);
+    const bool           combo  = IS_COMBOEVENT(record->event);
+    const uint32_t       now    = LATENCY_TIMESTAMP();
+
+    for (uint8_t i = 0; i < LATENCY_TRACE_PENDING; ++i) {
+        pending_event_t *entry = &pending[i];
+        if (entry->state != PENDING_DETECTED || entry->pressed != record->event.pressed) {
+            continue;
+        }
+
+        // A combo resolves the keys that triggered it, which are still waiting to be resolved
+        if (combo ? entry->combined : KEYEQ(entry->key, record->event.key)) {
+            if (traced) {
+                entry->state        = PENDING_RESOLVED;
+                entry->type         = type;
+                entry->code         = code;
+                entry->mods         = mods;
+                entry->resolve_time = now;
+            } else {
+                entry->state = PENDING_FREE;
+            }
+            if (!combo) {
+                break;
+            }
+        }
+    }
+}
+
+static bool is_reported(const pending_event_t *entry, report_keyboard_t *report) {
+    if (entry->type == LATENCY_EVENT_TAP_DANCE) {
+        return memcmp(report, &last_report, sizeof(report_keyboard_t)) != 0;
+    }
+    if (entry->pressed) {
+        return (entry->code == KC_NO || is_key_pressed(report, entry->code)) && (report->mods & entry->mods) == entry->mods;
+    }
+    return (entry->code == KC_NO || !is_key_pressed(report, entry->code)) && (report->mods & entry->mods) == 0;
+}
+
+void latency_trace_report_sent(report_keyboard_t *report) {
+    const uint32_t now = LATENCY_TIMESTAMP();
+
+    for (uint8_t i = 0; i < LATENCY_TRACE_PENDING; ++i) {
+        pending_event_t *entry = &pending[i];
+        if (entry->state != PENDING_RESOLVED || !is_reported(entry, report)) {
+            continue;
+        }
+
+        if (entry->debounce != UINT32_MAX) {
+            histogram_add(entry->type, LATENCY_STAGE_DEBOUNCE, entry->debounce);
+        }
+        histogram_add(entry->type, LATENCY_STAGE_PROCESSING, LATENCY_TICKS_TO_US(entry->resolve_time - entry->detect_time));
+        histogram_add(entry->type, LATENCY_STAGE_REPORT, LATENCY_TICKS_TO_US(now - entry->resolve_time));
+        histogram_add(entry->type, LATENCY_STAGE_TOTAL, LATENCY_TICKS_TO_US(now - entry->detect_time));
+        entry->state = PENDING_FREE;
+    }
+    last_report = *report;
+}
+
+const latency_histogram_t *latency_trace_get_histogram(latency_event_type_t type, latency_stage_t stage) {
+    if (type >= LATENCY_EVENT_TYPE_COUNT || stage >= LATENCY_STAGE_COUNT) {
+        return NULL;
+    }
+    return &histograms[type][stage];
+}
+
+void latency_trace_reset(void) {
+    memset(histograms, 0, sizeof(histograms));
+    memset(pending, 0, sizeof(pending));
+    memset(&last_report, 0, sizeof(last_report));
+    raw_change_pending = false;
+    raw_change_seen    = false;
+    histograms_updated = false;
+}
+
+uint32_t latency_trace_resolution(void) {
+    return LATENCY_RESOLUTION_US;
+}
+
+void latency_trace_print(void) {
+#ifdef CONSOLE_ENABLE
+    static const char *const type_names[LATENCY_EVENT_TYPE_COUNT] = {"plain", "mod-tap", "combo", "tap dance"};
+    static const char *const stage_names[LATENCY_STAGE_COUNT]     = {"debounce", "processing", "report", "total"};
+
+    // Off the cycle counter every latency is a whole number of milliseconds, even though it is printed in microseconds
+    dprintf("latency resolution: %luus\n", (unsigned long)LATENCY_RESOLUTION_US);
+    for (uint8_t type = 0; type < LATENCY_EVENT_TYPE_COUNT; ++type) {
+        for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+            const latency_histogram_t *histogram = &histograms[type][stage];
+            if (histogram->count == 0) {
+                continue;
+            }
+            dprintf("latency %s %s: count %u, avg %luus, max %luus, buckets", type_names[type], stage_names[stage], histogram->count, (unsigned long)(histogram->total / histogram->count), (unsigned long)histogram->max);
+            for (uint8_t bucket = 0; bucket < LATENCY_TRACE_BUCKETS; ++bucket) {
+                dprintf(" %u", histogram->buckets[bucket]);
+            }
+            dprintf("\n");
+        }
+    }
+#endif
+}
+
+void latency_trace_task(void) {
+#if LATENCY_TRACE_PRINT_INTERVAL > 0
+    static uint32_t print_timer = 0;
+
+    if (histograms_updated && timer_elapsed32(print_timer) >= LATENCY_TRACE_PRINT_INTERVAL) {
+        latency_trace_print();
+        histograms_updated = false;
+        print_timer        = timer_read32();
+    }
+#endif
+}
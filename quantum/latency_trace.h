@@ -0,0 +1,96 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+#include "report.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @enum How a traced key event was resolved into a report.
+ */
+typedef enum {
+    LATENCY_EVENT_PLAIN,
+    LATENCY_EVENT_MOD_TAP,
+    LATENCY_EVENT_COMBO,
+    LATENCY_EVENT_TAP_DANCE,
+    LATENCY_EVENT_TYPE_COUNT,
+} latency_event_type_t;
+
+/**
+ * @enum The part of the press-to-report path a latency was measured for.
+ *
+ * LATENCY_STAGE_DEBOUNCE: first raw matrix change to the debounced change seen by matrix_task()
+ * LATENCY_STAGE_PROCESSING: debounced change to the event being resolved by the action pipeline
+ * LATENCY_STAGE_REPORT: resolution to the report being handed to the host driver
+ * LATENCY_STAGE_TOTAL: debounced change to the report being handed to the host driver
+ */
+typedef enum {
+    LATENCY_STAGE_DEBOUNCE,
+    LATENCY_STAGE_PROCESSING,
+    LATENCY_STAGE_REPORT,
+    LATENCY_STAGE_TOTAL,
+    LATENCY_STAGE_COUNT,
+} latency_stage_t;
+
+/* Latencies are in microseconds. Bucket 0 holds those below 32us, bucket n those in [2^(n+4), 2^(n+5)) and the last one
+ * everything from 2^19us (524ms) up */
+#define LATENCY_TRACE_BUCKETS 16
+
+typedef struct {
+    uint16_t buckets[LATENCY_TRACE_BUCKETS];
+    uint16_t count;
+    uint32_t max;
+    uint64_t total;
+} latency_histogram_t;
+
+/**
+ * Records a raw matrix change, before debouncing. Called by the matrix implementation.
+ */
+void latency_trace_matrix_changed(void);
+
+/**
+ * Records a debounced key change detected by matrix_task().
+ */
+void latency_trace_key_detected(keyevent_t event);
+
+/**
+ * Marks a detected key event as taken by a combo, it is then resolved along with the combo. Called by process_combo().
+ */
+void latency_trace_combo_key(keyevent_t event);
+
+/**
+ * Records a key event reaching the action handler, classifying it by the action it resolved to. Events that do not
+ * change the keyboard report are dropped.
+ */
+void latency_trace_key_resolved(keyrecord_t *record, action_t action);
+
+/**
+ * Completes the resolved key events whose change made it into a keyboard report handed to the host driver.
+ */
+void latency_trace_report_sent(report_keyboard_t *report);
+
+/**
+ * The step latencies are timed in, in microseconds: 1 where the CPU cycle counter is used, and 1000 where only the
+ * millisecond timer is available. The histograms are in microseconds either way.
+ */
+uint32_t latency_trace_resolution(void);
+
+const latency_histogram_t *latency_trace_get_histogram(latency_event_type_t type, latency_stage_t stage);
+void                       latency_trace_reset(void);
+void                       latency_trace_print(void);
+
+/**
+ * Periodically dumps the histograms to the console, invoked from the main loop.
+ */
+void latency_trace_task(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,6 +21,7 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "profile.h"
 #include <string.h>
 #include <math.h>
 #include "led_tables.h"
@@ -369,14 +370,14 @@ void led_matrix_task(void) {
             led_task_start();
             break;
         case RENDERING:
-            led_task_render(effect);
+            PROFILE_CALL(led_task_render, effect);
             if (effect) {
                 led_matrix_indicators();
                 led_matrix_indicators_advanced(&led_effect_params);
             }
             break;
         case FLUSHING:
-            led_task_flush(effect);
+            PROFILE_CALL(led_task_flush, effect);
             break;
         case SYNCING:
             led_task_sync();
@@ -384,6 +385,20 @@ void led_matrix_task(void) {
     }
 }
 
+uint32_t led_matrix_next_deadline(void) {
+    const uint32_t now = timer_read32();
+
+    // Rendering and flushing carry on as soon as possible, only the wait for the next frame can be skipped
+    if (led_task_state == SYNCING) {
+        const uint32_t elapsed = sync_timer_elapsed32(g_led_timer);
+        if (elapsed < LED_MATRIX_LED_FLUSH_LIMIT) {
+            return now + (LED_MATRIX_LED_FLUSH_LIMIT - elapsed);
+        }
+    }
+
+    return now;
+}
+
 void led_matrix_indicators(void) {
     led_matrix_indicators_kb();
     led_matrix_indicators_user();
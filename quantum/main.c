@@ -15,6 +15,9 @@
  */
 
 #include "keyboard.h"
+#ifdef TICKLESS_IDLE_ENABLE
+#    include "tickless_idle.h"
+#endif
 
 void platform_setup(void);
 
@@ -72,5 +75,10 @@ int main(void) {
 #endif // DEFERRED_EXEC_ENABLE
 
         housekeeping_task();
+
+#ifdef TICKLESS_IDLE_ENABLE
+        // Sleep until something is due
+        tickless_idle_task();
+#endif
     }
 }
@@ -21,6 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#include "matrix_port.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -160,6 +164,11 @@ static void unselect_rows(void) {
     }
 }
 
+#            ifdef MATRIX_PORT_READ
+static matrix_port_group_t col_port_groups[MATRIX_PORT_MAX_GROUPS];
+static uint8_t             col_port_group_count = 0;
+#            endif
+
 __attribute__((weak)) void matrix_init_pins(void) {
     unselect_rows();
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
@@ -167,16 +176,20 @@ __attribute__((weak)) void matrix_init_pins(void) {
             setPinInputHigh_atomic(col_pins[x]);
         }
     }
+#            ifdef MATRIX_PORT_READ
+    col_port_group_count = matrix_port_groups_init(col_pins, MATRIX_COLS, col_port_groups, MATRIX_PORT_MAX_GROUPS);
+#            endif
 }
 
-__attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
-    // Start with a clear matrix row
-    matrix_row_t current_row_value = 0;
-
-    if (!select_row(current_row)) { // Select row
-        return;                     // skip NO_PIN row
+static matrix_row_t read_cols(void) {
+#            ifdef MATRIX_PORT_READ
+    // Read a whole port at a time when the column pins allow it
+    if (col_port_group_count) {
+        return matrix_port_groups_read(col_port_groups, col_port_group_count);
     }
-    matrix_output_select_delay();
+#            endif
+
+    matrix_row_t current_row_value = 0;
 
     // For each col...
     matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
@@ -187,6 +200,17 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
         current_row_value |= pin_state ? 0 : row_shifter;
     }
 
+    return current_row_value;
+}
+
+__attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
+    if (!select_row(current_row)) { // Select row
+        return;                     // skip NO_PIN row
+    }
+    matrix_output_select_delay();
+
+    matrix_row_t current_row_value = read_cols();
+
     // Unselect row
     unselect_row(current_row);
     matrix_output_unselect_delay(current_row, current_row_value != 0); // wait for all Col signals to go HIGH
@@ -317,7 +341,7 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 }
 #endif
 
-uint8_t matrix_scan(void) {
+bool matrix_scan_keys(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
@@ -336,10 +360,28 @@ uint8_t matrix_scan(void) {
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
 
+#ifdef LATENCY_TRACE_ENABLE
+    if (changed) latency_trace_matrix_changed();
+#endif
+
+#ifdef SPLIT_KEYBOARD
+    return debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+#else
+    return debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+#endif
+}
+
+uint8_t matrix_scan(void) {
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+    // Keys are scanned off the main loop, see background_matrix_scan.c
+    bool changed = false;
+#else
+    bool changed = matrix_scan_keys();
+#endif
+
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    changed |= matrix_post_scan();
 #else
-    changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
     matrix_scan_quantum();
 #endif
     return (uint8_t)changed;
@@ -4,6 +4,12 @@
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+#    include "atomic_util.h"
+#endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -55,17 +61,31 @@ inline uint8_t matrix_cols(void) {
     return MATRIX_COLS;
 }
 
+/* The background matrix scan writes the rows from its interrupt or thread, rows wider than a single load could
+ * otherwise be read half updated. */
+static inline matrix_row_t read_row(const matrix_row_t *rows, uint8_t row) {
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+    matrix_row_t value;
+    ATOMIC_BLOCK_FORCEON {
+        value = rows[row];
+    }
+    return value;
+#else
+    return rows[row];
+#endif
+}
+
 inline bool matrix_is_on(uint8_t row, uint8_t col) {
-    return (matrix[row] & ((matrix_row_t)1 << col));
+    return (read_row(matrix, row) & ((matrix_row_t)1 << col));
 }
 
 inline matrix_row_t matrix_get_row(uint8_t row) {
     // Matrix mask lets you disable switches in the returned matrix data. For example, if you have a
     // switch blocker installed and the switch is always pressed.
 #ifdef MATRIX_MASKED
-    return matrix[row] & matrix_mask[row];
+    return read_row(matrix, row) & matrix_mask[row];
 #else
-    return matrix[row];
+    return read_row(matrix, row);
 #endif
 }
 
@@ -165,13 +185,31 @@ __attribute__((weak)) void matrix_init(void) {
     matrix_init_quantum();
 }
 
-__attribute__((weak)) uint8_t matrix_scan(void) {
+__attribute__((weak)) bool matrix_scan_keys(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
+#ifdef LATENCY_TRACE_ENABLE
+    if (changed) latency_trace_matrix_changed();
+#endif
+
+#ifdef SPLIT_KEYBOARD
+    return debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+#else
+    return debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+#endif
+}
+
+__attribute__((weak)) uint8_t matrix_scan(void) {
+#ifdef BACKGROUND_MATRIX_SCAN_ENABLE
+    // Keys are scanned off the main loop, see background_matrix_scan.c
+    bool changed = false;
+#else
+    bool changed = matrix_scan_keys();
+#endif
+
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    changed |= matrix_post_scan();
 #else
-    changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
     matrix_scan_quantum();
 #endif
 
@@ -179,5 +217,5 @@ __attribute__((weak)) uint8_t matrix_scan(void) {
 }
 
 __attribute__((weak)) bool peek_matrix(uint8_t row_index, uint8_t col_index, bool raw) {
-    return 0 != ((raw ? raw_matrix[row_index] : matrix[row_index]) & (MATRIX_ROW_SHIFTER << col_index));
+    return 0 != (read_row(raw ? raw_matrix : matrix, row_index) & (MATRIX_ROW_SHIFTER << col_index));
 }
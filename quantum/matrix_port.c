@@ -0,0 +1,69 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_port.h"
+
+#ifdef MATRIX_PORT_READ
+
+uint8_t matrix_port_groups_init(const pin_t *pins, uint8_t count, matrix_port_group_t *groups, uint8_t max_groups) {
+    uint8_t group_count = 0;
+
+    for (uint8_t col = 0; col < count; col++) {
+        const pin_t pin = pins[col];
+        if (pin == NO_PIN) {
+            continue;
+        }
+
+        const uint8_t pad   = getPinPad(pin);
+        const int8_t  shift = (int8_t)col - (int8_t)pad;
+
+        // Join an existing group, or insert a new one after the last group on the same port
+        uint8_t position = group_count;
+        bool    joined   = false;
+        for (uint8_t i = 0; i < group_count; i++) {
+            if (isSamePort(groups[i].pin, pin)) {
+                if (groups[i].shift == shift) {
+                    groups[i].mask |= (pin_port_data_t)1 << pad;
+                    joined = true;
+                    break;
+                }
+                position = i + 1;
+            }
+        }
+        if (joined) {
+            continue;
+        }
+
+        if (group_count == max_groups) {
+            return 0;
+        }
+        for (uint8_t i = group_count; i > position; i--) {
+            groups[i] = groups[i - 1];
+        }
+        groups[position] = (matrix_port_group_t){.pin = pin, .mask = (pin_port_data_t)1 << pad, .shift = shift};
+        group_count++;
+    }
+
+    return group_count;
+}
+
+matrix_row_t matrix_port_groups_read(const matrix_port_group_t *groups, uint8_t group_count) {
+    matrix_row_t    row  = 0;
+    pin_port_data_t data = 0;
+
+    for (uint8_t i = 0; i < group_count; i++) {
+        const matrix_port_group_t *group = &groups[i];
+
+        // Groups on the same port are adjacent, so each port is only read once. Pins are pulled up, pressed is low.
+        if (i == 0 || !isSamePort(group->pin, groups[i - 1].pin)) {
+            data = ~readPinPort(group->pin);
+        }
+
+        const pin_port_data_t bits = data & group->mask;
+        row |= group->shift >= 0 ? (matrix_row_t)bits << group->shift : (matrix_row_t)(bits >> -group->shift);
+    }
+
+    return row;
+}
+
+#endif
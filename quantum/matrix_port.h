@@ -0,0 +1,56 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "gpio.h"
+#include "matrix.h"
+
+// Port reads need platform support, see readPinPort() in the platform's gpio.h
+#if defined(readPinPort) && !defined(MATRIX_NO_PORT_READ)
+#    define MATRIX_PORT_READ
+#endif
+
+#ifdef MATRIX_PORT_READ
+
+// Beyond this many groups, reading the pins one by one is just as quick
+#    ifndef MATRIX_PORT_MAX_GROUPS
+#        define MATRIX_PORT_MAX_GROUPS ((MATRIX_COLS + 1) / 2)
+#    endif
+
+/**
+ * @struct A set of column pins on the same port, which map onto row bits with the same shift.
+ */
+typedef struct {
+    pin_t           pin;   // any pin of the port, used to read it
+    pin_port_data_t mask;  // pads of the port belonging to the group
+    int8_t          shift; // column index minus pad number
+} matrix_port_group_t;
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+/**
+ * Groups column pins by port, so that a row can be read with a single access per port. Groups on the same port are
+ * kept next to each other. Columns set to NO_PIN are left out.
+ *
+ * @param pins[in] the column pins, indexed by column
+ * @param count[in] the number of columns
+ * @param groups[out] storage for the groups
+ * @param max_groups[in] the capacity of the groups array
+ * @return the number of groups, or zero if the pins need more than max_groups and should be read one by one
+ */
+uint8_t matrix_port_groups_init(const pin_t *pins, uint8_t count, matrix_port_group_t *groups, uint8_t max_groups);
+
+/**
+ * Reads the active-low column pins, returning them as a matrix row.
+ */
+matrix_row_t matrix_port_groups_read(const matrix_port_group_t *groups, uint8_t group_count);
+
+#    ifdef __cplusplus
+}
+#    endif
+
+#endif
@@ -0,0 +1,106 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "matrix_port.h"
+}
+
+class MatrixPort : public ::testing::Test {
+   protected:
+    matrix_port_group_t groups[MATRIX_COLS];
+
+    void SetUp() override {
+        for (auto &port : mock_ports) {
+            port = 0xFFFF; // pulled up, nothing pressed
+        }
+        mock_port_reads = 0;
+    }
+
+    /* Reference implementation, reading the pins one by one */
+    static matrix_row_t read_pins(const std::vector<pin_t> &pins) {
+        matrix_row_t row = 0;
+        for (size_t col = 0; col < pins.size(); col++) {
+            if (pins[col] != NO_PIN && !readPin(pins[col])) {
+                row |= MATRIX_ROW_SHIFTER << col;
+            }
+        }
+        return row;
+    }
+
+    static void press(pin_t pin) {
+        mock_ports[pin >> 4] &= ~(1 << (pin & 0xF));
+    }
+};
+
+TEST_F(MatrixPort, contiguous_pins_form_a_single_group) {
+    std::vector<pin_t> pins;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        pins.push_back(MOCK_PIN(1, col + 2));
+    }
+
+    ASSERT_EQ(matrix_port_groups_init(pins.data(), pins.size(), groups, MATRIX_COLS), 1);
+
+    press(pins[0]);
+    press(pins[5]);
+    press(pins[11]);
+    EXPECT_EQ(matrix_port_groups_read(groups, 1), 0b100000100001);
+    EXPECT_EQ(mock_port_reads, 1);
+}
+
+TEST_F(MatrixPort, each_port_is_read_once) {
+    // Two runs on port 0, split by a run on port 2, and a reversed pair on port 3
+    std::vector<pin_t> pins = {
+        MOCK_PIN(0, 0), MOCK_PIN(0, 1), MOCK_PIN(0, 2), MOCK_PIN(2, 8), MOCK_PIN(2, 9), MOCK_PIN(2, 10), MOCK_PIN(0, 12), MOCK_PIN(0, 13), MOCK_PIN(3, 5), MOCK_PIN(3, 4), NO_PIN, MOCK_PIN(2, 15),
+    };
+
+    const uint8_t group_count = matrix_port_groups_init(pins.data(), pins.size(), groups, MATRIX_COLS);
+    ASSERT_EQ(group_count, 6);
+
+    matrix_port_groups_read(groups, group_count);
+    EXPECT_EQ(mock_port_reads, 3);
+}
+
+TEST_F(MatrixPort, matches_reading_pins_one_by_one) {
+    std::vector<pin_t> pins = {
+        MOCK_PIN(0, 15), MOCK_PIN(1, 3), MOCK_PIN(1, 4), NO_PIN, MOCK_PIN(0, 0), MOCK_PIN(0, 1), MOCK_PIN(3, 7), MOCK_PIN(3, 8), MOCK_PIN(3, 9), MOCK_PIN(1, 11), MOCK_PIN(0, 14), MOCK_PIN(2, 0),
+    };
+
+    const uint8_t group_count = matrix_port_groups_init(pins.data(), pins.size(), groups, MATRIX_COLS);
+    ASSERT_GT(group_count, 0);
+
+    // Walk through pseudo-random port states, with the unused pads changing as well
+    uint32_t state = 12345;
+    for (int i = 0; i < 1000; i++) {
+        for (auto &port : mock_ports) {
+            state = state * 1103515245 + 12345;
+            port  = state >> 8;
+        }
+        EXPECT_EQ(matrix_port_groups_read(groups, group_count), read_pins(pins));
+    }
+}
+
+TEST_F(MatrixPort, no_pin_columns_are_never_pressed) {
+    std::vector<pin_t> pins(MATRIX_COLS, NO_PIN);
+    pins[3] = MOCK_PIN(2, 3);
+
+    const uint8_t group_count = matrix_port_groups_init(pins.data(), pins.size(), groups, MATRIX_COLS);
+    ASSERT_EQ(group_count, 1);
+
+    for (auto &port : mock_ports) {
+        port = 0;
+    }
+    EXPECT_EQ(matrix_port_groups_read(groups, group_count), 1 << 3);
+}
+
+TEST_F(MatrixPort, scattered_pins_fall_back_to_reading_one_by_one) {
+    std::vector<pin_t> pins;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        pins.push_back(MOCK_PIN(col % MOCK_PORT_COUNT, 15 - col));
+    }
+
+    EXPECT_EQ(matrix_port_groups_init(pins.data(), pins.size(), groups, MATRIX_PORT_MAX_GROUPS), 0);
+}
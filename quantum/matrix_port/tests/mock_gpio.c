@@ -0,0 +1,12 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "mock_gpio.h"
+
+pin_port_data_t mock_ports[MOCK_PORT_COUNT];
+uint32_t        mock_port_reads;
+
+pin_port_data_t mock_read_port(pin_t pin) {
+    mock_port_reads++;
+    return mock_ports[pin >> 4];
+}
@@ -0,0 +1,31 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pins are encoded as (port << 4) | pad, with four 16-bit ports */
+typedef uint8_t  pin_t;
+typedef uint16_t pin_port_data_t;
+
+#define MOCK_PORT_COUNT 4
+#define MOCK_PIN(port, pad) ((pin_t)(((port) << 4) | (pad)))
+
+extern pin_port_data_t mock_ports[MOCK_PORT_COUNT];
+extern uint32_t        mock_port_reads;
+
+pin_port_data_t mock_read_port(pin_t pin);
+
+#define readPin(pin) ((mock_ports[(pin) >> 4] >> ((pin)&0xF)) & 1)
+#define readPinPort(pin) mock_read_port(pin)
+#define getPinPad(pin) ((pin)&0xF)
+#define isSamePort(pin_a, pin_b) (((pin_a) >> 4) == ((pin_b) >> 4))
+
+#ifdef __cplusplus
+}
+#endif
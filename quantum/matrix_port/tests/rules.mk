@@ -0,0 +1,7 @@
+matrix_port_DEFS := -DMATRIX_ROWS=1 -DMATRIX_COLS=12
+matrix_port_CONFIG := $(QUANTUM_PATH)/matrix_port/tests/mock_gpio.h
+
+matrix_port_SRC := \
+	$(QUANTUM_PATH)/matrix_port/tests/mock_gpio.c \
+	$(QUANTUM_PATH)/matrix_port/tests/matrix_port_tests.cpp \
+	$(QUANTUM_PATH)/matrix_port.c
@@ -380,3 +380,10 @@ void qp_internal_animation_tick(void) {
     static uint32_t last_anim_exec = 0;
     deferred_exec_advanced_task(animation_executors, QUANTUM_PAINTER_CONCURRENT_ANIMATIONS, &last_anim_exec);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter Core API: qp_internal_animation_next_deadline
+
+bool qp_internal_animation_next_deadline(uint32_t *deadline) {
+    return deferred_exec_advanced_next_deadline(animation_executors, QUANTUM_PAINTER_CONCURRENT_ANIMATIONS, deadline);
+}
@@ -19,6 +19,9 @@
 #include "pointing_device.h"
 #include <string.h>
 #include "timer.h"
+#ifdef KEYSTROKE_TRACE_ENABLE
+#    include "keystroke_trace.h"
+#endif
 #ifdef MOUSEKEY_ENABLE
 #    include "mousekey.h"
 #endif
@@ -256,6 +259,10 @@ __attribute__((weak)) void pointing_device_task(void) {
     local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
 #endif // defined(SPLIT_POINTING_ENABLE)
 
+#ifdef KEYSTROKE_TRACE_ENABLE
+    keystroke_trace_record_pointing(local_mouse_report);
+#endif
+
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
     if (is_keyboard_left()) {
@@ -2,6 +2,9 @@
 
 float compute_freq_for_midi_note(uint8_t note);
 
+// Audio on/off and voice selection
+#define AUDIO_KEYCODE_RANGES {AU_ON, AU_TOG}, {MUV_IN, MUV_DE}
+
 bool process_audio(uint16_t keycode, keyrecord_t *record);
 void process_audio_noteon(uint8_t note);
 void process_audio_noteoff(uint8_t note);
@@ -18,4 +18,6 @@
 
 #include "quantum.h"
 
+#define BACKLIGHT_KEYCODE_RANGES {BL_ON, BL_BRTG}
+
 bool process_backlight(uint16_t keycode, keyrecord_t *record);
@@ -14,10 +14,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "print.h"
 #include "process_combo.h"
 #include "action_tapping.h"
 #include "action.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 
 #ifdef COMBO_COUNT
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT];
@@ -70,6 +74,22 @@ static uint16_t timer = 0;
 #endif
 static bool     b_combo_enable = true; // defaults to enabled
 static uint16_t longest_term   = 0;
+// Set once a key event reaches any combo, so clear_combos() can skip the reset when none were touched
+static bool combos_touched = false;
+
+#ifdef COMBO_KEY_INDEX_LENGTH
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_key_index_t;
+
+// Every keycode used by the combos along with the combo using it, sorted by keycode, then by combo index
+static combo_key_index_t combo_key_index[COMBO_KEY_INDEX_LENGTH];
+static uint16_t          combo_key_index_size  = 0;
+static bool              combo_key_index_built = false;
+// Set when the combos have more keys than the index holds, all combos are then checked on every key event
+static bool combo_key_index_overflow = false;
+#endif
 
 typedef struct {
     keyrecord_t record;
@@ -188,6 +208,10 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+    if (!combos_touched) {
+        return;
+    }
+    combos_touched = false;
     for (index = 0; index < COMBO_LEN; ++index) {
         combo_t *combo = &key_combos[index];
         if (!COMBO_ACTIVE(combo)) {
@@ -250,7 +274,6 @@ static inline void dump_key_buffer(void) {
     key_buffer_next = key_buffer_size = 0;
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
 #define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << key_count) - 1) == state)
 #define ONLY_ONE_KEY_IS_DOWN(state) !(state & (state - 1))
 #define KEY_NOT_YET_RELEASED(state, key_index) ((1 << key_index) & state)
@@ -323,6 +346,9 @@ void apply_combo(uint16_t combo_index, combo_t *combo) {
             continue;
         }
 
+#ifdef LATENCY_TRACE_ENABLE
+        latency_trace_combo_key(record->event);
+#endif
         KEY_STATE_DOWN(state, key_index);
         if (ALL_COMBO_KEYS_ARE_DOWN(state, key_count)) {
             // this in the end executes the combo when the key_buffer is dumped.
@@ -416,6 +442,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     if (-1 == (int16_t)key_index) {
         return false;
     }
+    combos_touched = true;
 
     bool key_is_part_of_combo = (!COMBO_DISABLED(combo) && is_combo_enabled()
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
@@ -501,6 +528,9 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
 #endif
         } else if (COMBO_ACTIVE(combo) && ONLY_ONE_KEY_IS_DOWN(COMBO_STATE(combo)) && KEY_NOT_YET_RELEASED(COMBO_STATE(combo), key_index)) {
             /* last key released */
+#ifdef LATENCY_TRACE_ENABLE
+            latency_trace_combo_key(record->event);
+#endif
             release_combo(combo_index, combo);
             key_is_part_of_combo = true;
 
@@ -510,6 +540,9 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
         } else if (COMBO_ACTIVE(combo) && KEY_NOT_YET_RELEASED(COMBO_STATE(combo), key_index)) {
             /* first or middle key released */
             key_is_part_of_combo = true;
+#ifdef LATENCY_TRACE_ENABLE
+            latency_trace_combo_key(record->event);
+#endif
 
 #ifdef COMBO_PROCESS_KEY_RELEASE
             if (process_combo_key_release(combo_index, combo, key_index, keycode)) {
@@ -527,9 +560,53 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     return key_is_part_of_combo;
 }
 
+#ifdef COMBO_KEY_INDEX_LENGTH
+static void build_combo_key_index(void) {
+    combo_key_index_size     = 0;
+    combo_key_index_overflow = false;
+    combo_key_index_built    = true;
+
+    for (uint16_t combo_index = 0; combo_index < COMBO_LEN; ++combo_index) {
+        const uint16_t *keys = key_combos[combo_index].keys;
+        uint16_t        key;
+        for (uint8_t i = 0; (key = pgm_read_word(&keys[i])) != COMBO_END; ++i) {
+            // Combos are added in order, so the new entry goes after every entry with the same keycode
+            uint16_t pos = combo_key_index_size;
+            while (pos > 0 && combo_key_index[pos - 1].keycode > key) {
+                pos--;
+            }
+            if (pos > 0 && combo_key_index[pos - 1].keycode == key && combo_key_index[pos - 1].combo_index == combo_index) {
+                // key is listed twice in this combo
+                continue;
+            }
+            if (combo_key_index_size >= COMBO_KEY_INDEX_LENGTH) {
+                combo_key_index_overflow = true;
+                return;
+            }
+            memmove(&combo_key_index[pos + 1], &combo_key_index[pos], (combo_key_index_size - pos) * sizeof(combo_key_index_t));
+            combo_key_index[pos] = (combo_key_index_t){.keycode = key, .combo_index = combo_index};
+            combo_key_index_size++;
+        }
+    }
+}
+
+/* Returns the position of the first index entry for keycode, or of the entry that follows it when there is none. */
+static uint16_t find_combo_key_index(uint16_t keycode) {
+    uint16_t low = 0, high = combo_key_index_size;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_key_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -551,10 +628,22 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX_LENGTH
+    if (!combo_key_index_built) {
+        build_combo_key_index();
+    }
+    if (!combo_key_index_overflow) {
+        /* Only the combos using this keycode, in the same order as key_combos */
+        for (uint16_t i = find_combo_key_index(keycode); i < combo_key_index_size && combo_key_index[i].keycode == keycode; ++i) {
+            uint16_t idx = combo_key_index[i].combo_index;
+            is_combo_key |= process_single_combo(&key_combos[idx], keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            is_combo_key |= process_single_combo(&key_combos[idx], keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -612,6 +701,20 @@ void combo_task(void) {
 #endif
 }
 
+bool combo_next_deadline(uint32_t *deadline) {
+#ifndef COMBO_NO_TIMER
+    if (b_combo_enable && timer) {
+        // combo_task() resolves the buffered keys once the longest term has been exceeded
+        uint16_t elapsed = timer_elapsed(timer);
+        if (elapsed <= longest_term) {
+            *deadline = timer_read32() + (longest_term - elapsed + 1);
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
 void combo_enable(void) {
     b_combo_enable = true;
 }
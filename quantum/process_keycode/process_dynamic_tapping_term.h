@@ -23,4 +23,6 @@
 #    define DYNAMIC_TAPPING_TERM_INCREMENT 5
 #endif
 
+#define DYNAMIC_TAPPING_TERM_KEYCODE_RANGES {DT_PRNT, DT_DOWN}
+
 bool process_dynamic_tapping_term(uint16_t keycode, keyrecord_t *record);
@@ -17,4 +17,6 @@
 
 #include "quantum.h"
 
+#define GRAVE_ESC_KEYCODE_RANGES {QK_GRAVE_ESCAPE, QK_GRAVE_ESCAPE}
+
 bool process_grave_esc(uint16_t keycode, keyrecord_t *record);
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include "quantum.h"
 
+#define JOYSTICK_KEYCODE_RANGES {JS_BUTTON_MIN, JS_BUTTON_MAX}
+
 bool process_joystick(uint16_t keycode, keyrecord_t *record);
 
 void joystick_task(void);
@@ -243,141 +243,258 @@ static bool check_activation_event(const key_override_t *override, const bool ke
     }
 }
 
-/** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
-static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
-    if (key_overrides == NULL) {
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+#    if KEY_OVERRIDE_INDEX_LENGTH > UINT8_MAX
+#        error "KEY_OVERRIDE_INDEX_LENGTH must not exceed 255"
+#    endif
+
+typedef struct {
+    uint16_t trigger;
+    uint8_t  override_index;
+} key_override_index_t;
+
+// Every override in key_overrides, sorted by trigger, then by position in key_overrides
+static key_override_index_t    key_override_index[KEY_OVERRIDE_INDEX_LENGTH];
+static uint8_t                 key_override_index_size = 0;
+static const key_override_t **indexed_key_overrides   = NULL;
+// Set when key_overrides holds more overrides than the index, all overrides are then checked in turn
+static bool key_override_index_overflow = false;
+
+static void build_key_override_index(void) {
+    key_override_index_size     = 0;
+    key_override_index_overflow = false;
+    indexed_key_overrides       = key_overrides;
+
+    for (uint8_t i = 0; key_overrides[i] != NULL; i++) {
+        if (key_override_index_size >= KEY_OVERRIDE_INDEX_LENGTH) {
+            key_override_index_overflow = true;
+            return;
+        }
+
+        // Overrides are added in order, so the new entry goes after every entry with the same trigger
+        const uint16_t trigger = key_overrides[i]->trigger;
+        uint8_t        pos     = key_override_index_size;
+        while (pos > 0 && key_override_index[pos - 1].trigger > trigger) {
+            key_override_index[pos] = key_override_index[pos - 1];
+            pos--;
+        }
+        key_override_index[pos] = (key_override_index_t){.trigger = trigger, .override_index = i};
+        key_override_index_size++;
+    }
+}
+
+/** Returns the position of the first index entry for trigger, or of the entry that follows it when there is none. */
+static uint8_t find_key_override_index(const uint16_t trigger) {
+    uint8_t low = 0, high = key_override_index_size;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (key_override_index[mid].trigger < trigger) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif
+
+/** Cheaper check than key_override_matches_active_modifiers, only returns false if the override can not match the mods. */
+static bool key_override_may_match_active_modifiers(const key_override_t *override, const uint8_t mods) {
+    if ((override->negative_mod_mask & mods) != 0) {
+        return false;
+    }
+    if (override->trigger_mods == 0) {
         return true;
     }
+    // At least one of the trigger modifiers must be down on either side
+    const uint8_t one_sided_mods         = (mods & 0b1111) | (mods >> 4);
+    const uint8_t one_sided_trigger_mods = (override->trigger_mods & 0b1111) | (override->trigger_mods >> 4);
+    return (one_sided_mods & one_sided_trigger_mods) != 0;
+}
 
-    for (uint8_t i = 0;; i++) {
-        const key_override_t *const override = key_overrides[i];
+/** Tries activating a single override. Returns true if it was activated, in which case send_key_action is set to whether the key action for `keycode` should be sent */
+static bool try_activating_single_override(const key_override_t *const override, const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *send_key_action) {
+    // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that cannot match the mods that are down, whichever side they are on
+    if (!key_override_may_match_active_modifiers(override, active_mods)) {
+        key_override_printf("Not activating override: Modifiers don't match\n");
+        return false;
+    }
 
-        // End of array
-        if (override == NULL) {
-            break;
-        }
+    // Check layer
+    if ((override->layers & (1 << layer)) == 0) {
+        key_override_printf("Not activating override: Not set to activate on pressed layer\n");
+        return false;
+    }
 
-        // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that require mods to be down while no mods are down
-        if (active_mods == 0 && override->trigger_mods != 0) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
-        }
+    // Check allowed activation events
+    if (!check_activation_event(override, key_down, is_mod)) {
+        key_override_printf("Not activating override: Activation event not allowed\n");
+        return false;
+    }
 
-        // Check layer
-        if ((override->layers & (1 << layer)) == 0) {
-            key_override_printf("Not activating override: Not set to activate on pressed layer\n");
-            continue;
-        }
+    const bool is_trigger = override->trigger == keycode;
 
-        // Check allowed activation events
-        if (!check_activation_event(override, key_down, is_mod)) {
-            key_override_printf("Not activating override: Activation event not allowed\n");
-            continue;
-        }
+    // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
+    if (is_trigger && !key_down) {
+        key_override_printf("Not activating override: Trigger lifted\n");
+        return false;
+    }
 
-        const bool is_trigger = override->trigger == keycode;
+    // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
+    const bool no_trigger = override->trigger == KC_NO;
 
-        // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
-        if (is_trigger && !key_down) {
-            key_override_printf("Not activating override: Trigger lifted\n");
-            continue;
-        }
+    // Check if aleady active
+    if (override == active_override) {
+        key_override_printf("Not activating override: Alerady actived\n");
+        return false;
+    }
 
-        // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
-        const bool no_trigger = override->trigger == KC_NO;
+    // Check if enabled
+    if (override->enabled != NULL && !((*(override->enabled) & 1))) {
+        key_override_printf("Not activating override: Not enabled\n");
+        return false;
+    }
 
-        // Check if aleady active
-        if (override == active_override) {
-            key_override_printf("Not activating override: Alerady actived\n");
-            continue;
-        }
+    // Check mods precisely
+    if (!key_override_matches_active_modifiers(override, active_mods)) {
+        key_override_printf("Not activating override: Modifiers don't match\n");
+        return false;
+    }
 
-        // Check if enabled
-        if (override->enabled != NULL && !((*(override->enabled) & 1))) {
-            key_override_printf("Not activating override: Not enabled\n");
-            continue;
-        }
+    // Check if trigger key is down.
+    const bool trigger_down = is_trigger && key_down;
 
-        // Check mods precisely
-        if (!key_override_matches_active_modifiers(override, active_mods)) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
-        }
+    // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
+    // If no trigger key is required, yes.
+    // If the trigger was just pressed, yes.
+    // If the last non-mod key that was pressed down is the trigger key, yes.
+    bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
 
-        // Check if trigger key is down.
-        const bool trigger_down = is_trigger && key_down;
+    if (!should_activate) {
+        key_override_printf("Not activating override. Trigger not down\n");
+        return false;
+    }
+
+    key_override_printf("Activating override\n");
+
+    clear_active_override(false);
+
+    active_override                 = override;
+    active_override_trigger_is_down = true;
 
-        // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
-        // If no trigger key is required, yes.
-        // If the trigger was just pressed, yes.
-        // If the last non-mod key that was pressed down is the trigger key, yes.
-        bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
+    set_suppressed_override_mods(override->suppressed_mods);
 
-        if (!should_activate) {
-            key_override_printf("Not activating override. Trigger not down\n");
-            continue;
+    if (!trigger_down && !no_trigger) {
+        // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
+        if (IS_KEY(override->trigger)) {
+            del_key(override->trigger);
+        } else {
+            unregister_code(override->trigger);
         }
+    }
 
-        key_override_printf("Activating override\n");
+    const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
 
-        clear_active_override(false);
+    bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
+                                mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
 
-        active_override                 = override;
-        active_override_trigger_is_down = true;
+    // Try firing the custom handler
+    if (override->custom_action != NULL) {
+        register_replacement &= override->custom_action(true, override->context);
+    }
 
-        set_suppressed_override_mods(override->suppressed_mods);
+    if (register_replacement) {
+        const uint8_t override_mods = extract_mod_bits(override->replacement);
+        set_weak_override_mods(override_mods);
 
-        if (!trigger_down && !no_trigger) {
-            // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
-            if (IS_KEY(override->trigger)) {
-                del_key(override->trigger);
+        // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
+        if (is_mod) {
+            key_override_printf("Deferring register replacement key\n");
+            schedule_deferred_register(mod_free_replacement);
+            send_keyboard_report();
+        } else {
+            if (IS_KEY(mod_free_replacement)) {
+                add_key(mod_free_replacement);
             } else {
-                unregister_code(override->trigger);
+                key_override_printf("NOT KEY 2\n");
+                send_keyboard_report();
+                // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
+                wait_ms(10);
+                register_code(mod_free_replacement);
             }
         }
+    } else {
+        // If not registering the replacement key send keyboard report to update the unregistered keys.
+        send_keyboard_report();
+    }
 
-        const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
+    // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
+    *send_key_action = !trigger_down;
+    return true;
+}
 
-        bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
-                                    mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
+/** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
+static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
+    bool send_key_action = true;
 
-        // Try firing the custom handler
-        if (override->custom_action != NULL) {
-            register_replacement &= override->custom_action(true, override->context);
-        }
+    *activated = false;
 
-        if (register_replacement) {
-            const uint8_t override_mods = extract_mod_bits(override->replacement);
-            set_weak_override_mods(override_mods);
+    if (key_overrides == NULL) {
+        return true;
+    }
 
-            // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
-            if (is_mod) {
-                key_override_printf("Deferring register replacement key\n");
-                schedule_deferred_register(mod_free_replacement);
-                send_keyboard_report();
-            } else {
-                if (IS_KEY(mod_free_replacement)) {
-                    add_key(mod_free_replacement);
-                } else {
-                    key_override_printf("NOT KEY 2\n");
-                    send_keyboard_report();
-                    // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
-                    wait_ms(10);
-                    register_code(mod_free_replacement);
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+    if (key_overrides != indexed_key_overrides) {
+        build_key_override_index();
+    }
+
+    if (!key_override_index_overflow) {
+        // Only overrides triggered by no key, by the key just pressed or by the last key pressed down can activate.
+        const uint16_t triggers[] = {KC_NO, last_key_down, key_down ? keycode : KC_NO};
+        const uint8_t  trigger_count = sizeof(triggers) / sizeof(triggers[0]);
+        uint8_t        next[sizeof(triggers) / sizeof(triggers[0])];
+
+        for (uint8_t t = 0; t < trigger_count; t++) {
+            next[t] = find_key_override_index(triggers[t]);
+            for (uint8_t u = 0; u < t; u++) {
+                if (triggers[u] == triggers[t]) {
+                    // Already visited through the other trigger
+                    next[t] = key_override_index_size;
                 }
             }
-        } else {
-            // If not registering the replacement key send keyboard report to update the unregistered keys.
-            send_keyboard_report();
         }
 
-        *activated = true;
+        // Visit the candidates of all triggers in the order of key_overrides, as the first override that matches wins
+        while (true) {
+            int8_t  candidate       = -1;
+            uint8_t candidate_index = 0;
+            for (uint8_t t = 0; t < trigger_count; t++) {
+                if (next[t] < key_override_index_size && key_override_index[next[t]].trigger == triggers[t] && (candidate < 0 || key_override_index[next[t]].override_index < candidate_index)) {
+                    candidate       = t;
+                    candidate_index = key_override_index[next[t]].override_index;
+                }
+            }
+            if (candidate < 0) {
+                break;
+            }
+            next[candidate]++;
+
+            if (try_activating_single_override(key_overrides[candidate_index], keycode, layer, key_down, is_mod, active_mods, &send_key_action)) {
+                *activated = true;
+                return send_key_action;
+            }
+        }
 
-        // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
-        return !trigger_down;
+        return true;
     }
+#endif
 
-    *activated = false;
+    for (uint8_t i = 0; key_overrides[i] != NULL; i++) {
+        if (try_activating_single_override(key_overrides[i], keycode, layer, key_down, is_mod, active_mods, &send_key_action)) {
+            *activated = true;
+            return send_key_action;
+        }
+    }
 
     return true;
 }
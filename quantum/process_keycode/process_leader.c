@@ -31,8 +31,128 @@ __attribute__((weak)) void leader_end(void) {}
 bool     leading     = false;
 uint16_t leader_time = 0;
 
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_MAX_LENGTH] = {0, 0, 0, 0, 0};
+uint8_t  leader_sequence_size                        = 0;
+
+#    ifdef LEADER_SEQUENCE_COUNT
+#        if LEADER_SEQUENCE_COUNT > UINT8_MAX
+#            error "LEADER_SEQUENCE_COUNT must not exceed 255"
+#        endif
+
+__attribute__((weak)) void process_leader_sequence(uint16_t index) {}
+
+// The sequences sorted by their keys, which lays them out like a trie: the sequences starting with the keys typed so
+// far are next to each other, ordered by the key that follows.
+static uint8_t sorted_sequences[LEADER_SEQUENCE_COUNT];
+static bool    sequences_sorted = false;
+// The range of sorted_sequences starting with the keys typed so far
+static uint8_t match_begin = 0;
+static uint8_t match_end   = 0;
+
+static inline uint16_t sequence_key(uint8_t index, uint8_t position) {
+    return position < LEADER_SEQUENCE_MAX_LENGTH ? pgm_read_word(&leader_sequences[index].keys[position]) : KC_NO;
+}
+
+static bool sequence_is_before(uint8_t a, uint8_t b) {
+    for (uint8_t i = 0; i < LEADER_SEQUENCE_MAX_LENGTH; i++) {
+        uint16_t key_a = sequence_key(a, i), key_b = sequence_key(b, i);
+        if (key_a != key_b) {
+            return key_a < key_b;
+        }
+    }
+    return false;
+}
+
+static void sort_sequences(void) {
+    // Insertion sort, sequences with the same keys stay in the order they are defined in
+    for (uint8_t i = 0; i < LEADER_SEQUENCE_COUNT; i++) {
+        uint8_t pos = i;
+        while (pos > 0 && sequence_is_before(i, sorted_sequences[pos - 1])) {
+            sorted_sequences[pos] = sorted_sequences[pos - 1];
+            pos--;
+        }
+        sorted_sequences[pos] = i;
+    }
+    sequences_sorted = true;
+}
+
+/* Returns the first position in [begin, end) where the key at depth is not below key, or above it if upper is set. */
+static uint8_t find_sequence_key(uint8_t begin, uint8_t end, uint8_t depth, uint16_t key, bool upper) {
+    while (begin < end) {
+        uint8_t  mid       = begin + (end - begin) / 2;
+        uint16_t mid_key   = sequence_key(sorted_sequences[mid], depth);
+        bool     go_higher = upper ? mid_key <= key : mid_key < key;
+        if (go_higher) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+/* Whether the first matching sequence has been typed in full. It comes first as it sorts before the longer ones. */
+static bool sequence_complete(void) {
+    return leader_sequence_size > 0 && match_begin < match_end && sequence_key(sorted_sequences[match_begin], leader_sequence_size) == KC_NO;
+}
+
+/* Whether the sequence typed so far can not become any other sequence. */
+static bool sequence_resolved(void) {
+    return match_begin == match_end || sequence_key(sorted_sequences[match_end - 1], leader_sequence_size) == KC_NO;
+}
+
+static void leader_sequence_end(void) {
+    bool complete = sequence_complete();
+
+    leading = false;
+    leader_end();
+
+    if (complete) {
+        uint8_t  index   = sorted_sequences[match_begin];
+        uint16_t keycode = pgm_read_word(&leader_sequences[index].keycode);
+        if (keycode) {
+            tap_code16(keycode);
+        } else {
+            process_leader_sequence(index);
+        }
+    }
+}
+
+static bool leader_timed_out(void) {
+#        ifdef LEADER_NO_TIMEOUT
+    return leading && leader_sequence_size > 0 && timer_elapsed(leader_time) > LEADER_TIMEOUT;
+#        else
+    return leading && timer_elapsed(leader_time) > LEADER_TIMEOUT;
+#        endif
+}
+
+void leader_table_task(void) {
+    if (leader_timed_out() && sequence_complete()) {
+        leader_sequence_end();
+    }
+}
+
+void leader_task(void) {
+    if (leader_timed_out()) {
+        leader_sequence_end();
+    }
+}
+
+bool leader_next_deadline(uint32_t *deadline) {
+    if (!leading) {
+        return false;
+    }
+#        ifdef LEADER_NO_TIMEOUT
+    if (leader_sequence_size == 0) {
+        return false;
+    }
+#        endif
+    // leader_task() ends the sequence once the timeout has been exceeded
+    uint16_t elapsed = timer_elapsed(leader_time);
+    *deadline        = timer_read32() + (elapsed <= LEADER_TIMEOUT ? LEADER_TIMEOUT - elapsed + 1 : 0);
+    return true;
+}
+#    endif
 
 void qk_leader_start(void) {
     if (leading) {
@@ -43,11 +163,22 @@ void qk_leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#    ifdef LEADER_SEQUENCE_COUNT
+    if (!sequences_sorted) {
+        sort_sequences();
+    }
+    match_begin = 0;
+    match_end   = LEADER_SEQUENCE_COUNT;
+#    endif
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
     // Leader key set-up
     if (record->event.pressed) {
+#    ifdef LEADER_SEQUENCE_COUNT
+        // Finish off a timed out sequence before this key, in case leader_task() has not run in between
+        leader_task();
+#    endif
         if (leading) {
 #    ifndef LEADER_NO_TIMEOUT
             if (timer_elapsed(leader_time) < LEADER_TIMEOUT)
@@ -60,7 +191,20 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
 #    endif // LEADER_KEY_STRICT_KEY_PROCESSING
                 if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
                     leader_sequence[leader_sequence_size] = keycode;
+#    ifdef LEADER_SEQUENCE_COUNT
+                    // Move down the trie, to the sequences continuing with this key
+                    match_begin = find_sequence_key(match_begin, match_end, leader_sequence_size, keycode, false);
+                    match_end   = find_sequence_key(match_begin, match_end, leader_sequence_size, keycode, true);
+#    endif
                     leader_sequence_size++;
+#    ifdef LEADER_SEQUENCE_COUNT
+                    if (sequence_complete() && sequence_resolved()) {
+                        // No need to wait for the timeout, this sequence can not become any other one. Sequences
+                        // that are not in the table wait for it, as the keymap may still check them with SEQ_*.
+                        leader_sequence_end();
+                        return false;
+                    }
+#    endif
                 } else {
                     leading = false;
                     leader_end();
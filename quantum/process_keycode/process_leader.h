@@ -18,22 +18,54 @@
 
 #include "quantum.h"
 
+#define LEADER_SEQUENCE_MAX_LENGTH 5
+
 bool process_leader(uint16_t keycode, keyrecord_t *record);
 
 void leader_start(void);
 void leader_end(void);
 void qk_leader_start(void);
 
+#ifdef LEADER_SEQUENCE_COUNT
+/** A sequence of keys following the leader key, see leader_sequences. */
+typedef struct {
+    uint16_t keys[LEADER_SEQUENCE_MAX_LENGTH];
+    uint16_t keycode;
+} leader_sequence_t;
+
+#    define LEADER_SEQUENCE(keycode_, ...) \
+        { .keys = {__VA_ARGS__}, .keycode = (keycode_) }
+#    define LEADER_SEQUENCE_ACTION(...) \
+        { .keys = {__VA_ARGS__}, .keycode = KC_NO }
+
+/**
+ * The sequences matched as the keys are typed, define this as an array of LEADER_SEQUENCE_COUNT entries.
+ *
+ * The keycode of a sequence is tapped as soon as it is typed, or once the leader timeout expires when it is also the
+ * start of a longer sequence. Sequences made with LEADER_SEQUENCE_ACTION() call process_leader_sequence() instead.
+ */
+extern const leader_sequence_t leader_sequences[LEADER_SEQUENCE_COUNT];
+
+void process_leader_sequence(uint16_t index);
+
+/** Fires a complete sequence once the timeout expires, ahead of LEADER_DICTIONARY() in matrix_scan_user(). */
+void leader_table_task(void);
+
+/** Ends the sequence once the timeout expires, after LEADER_DICTIONARY() in matrix_scan_user() had its turn. */
+void leader_task(void);
+bool leader_next_deadline(uint32_t *deadline);
+#endif
+
 #define SEQ_ONE_KEY(key) if (leader_sequence[0] == (key) && leader_sequence[1] == 0 && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
 #define SEQ_TWO_KEYS(key1, key2) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
 #define SEQ_THREE_KEYS(key1, key2, key3) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == 0 && leader_sequence[4] == 0)
 #define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
 #define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
-#define LEADER_EXTERNS()                \
-    extern bool     leading;            \
-    extern uint16_t leader_time;        \
-    extern uint16_t leader_sequence[5]; \
+#define LEADER_EXTERNS()                                         \
+    extern bool     leading;                                     \
+    extern uint16_t leader_time;                                 \
+    extern uint16_t leader_sequence[LEADER_SEQUENCE_MAX_LENGTH]; \
     extern uint8_t  leader_sequence_size
 
 #ifdef LEADER_NO_TIMEOUT
@@ -17,4 +17,10 @@
 
 #include "quantum.h"
 
+// Magic keycodes are spread over the keycode space, as they were added over time
+#define MAGIC_KEYCODE_RANGES                                                                                  \
+    {MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_ALT_GUI}, {MAGIC_SWAP_LCTL_LGUI, MAGIC_EE_HANDS_RIGHT},        \
+        {MAGIC_TOGGLE_GUI, MAGIC_TOGGLE_GUI}, {MAGIC_TOGGLE_CONTROL_CAPSLOCK, MAGIC_TOGGLE_CONTROL_CAPSLOCK}, \
+        {MAGIC_SWAP_ESCAPE_CAPSLOCK, MAGIC_TOGGLE_ESCAPE_CAPSLOCK}
+
 bool process_magic(uint16_t keycode, keyrecord_t *record);
@@ -43,6 +43,10 @@ typedef union {
 extern midi_config_t midi_config;
 
 void midi_init(void);
+
+// Notes, octave, transpose, velocity, channel and controller keys
+#        define MIDI_KEYCODE_RANGES {MIDI_TONE_MIN, MI_BENDU}
+
 bool process_midi(uint16_t keycode, keyrecord_t *record);
 
 #        define MIDI_INVALID_NOTE 0xFF
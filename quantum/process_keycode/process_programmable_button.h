@@ -20,4 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdint.h>
 #include "quantum.h"
 
+#define PROGRAMMABLE_BUTTON_KEYCODE_RANGES {PROGRAMMABLE_BUTTON_MIN, PROGRAMMABLE_BUTTON_MAX}
+
 bool process_programmable_button(uint16_t keycode, keyrecord_t *record);
@@ -17,4 +17,7 @@
 
 #include "quantum.h"
 
+// RGB_MODE_TWINKLE was added after the other RGB keycodes
+#define RGB_KEYCODE_RANGES {RGB_TOG, RGB_MODE_RGBTEST}, {RGB_MODE_TWINKLE, RGB_MODE_TWINKLE}
+
 bool process_rgb(const uint16_t keycode, const keyrecord_t *record);
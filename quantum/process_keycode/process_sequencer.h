@@ -18,4 +18,7 @@
 
 #include "quantum.h"
 
+// Sequencer controls, followed by the step, resolution and track keys
+#define SEQUENCER_KEYCODE_RANGES {SQ_ON, SEQUENCER_TRACK_MAX}
+
 bool process_sequencer(uint16_t keycode, keyrecord_t *record);
@@ -167,6 +167,18 @@ void tap_dance_task() {
     }
 }
 
+bool tap_dance_next_deadline(uint32_t *deadline) {
+    if (!active_td) return false;
+
+    // tap_dance_task() finishes the dance once the tapping term has been exceeded
+    uint16_t term    = GET_TAPPING_TERM(active_td, &(keyrecord_t){});
+    uint16_t elapsed = timer_elapsed(last_tap_time);
+    if (elapsed > term) return false;
+
+    *deadline = timer_read32() + (term - elapsed + 1);
+    return true;
+}
+
 void reset_tap_dance(qk_tap_dance_state_t *state) {
     active_td = 0;
     process_tap_dance_action_on_reset((qk_tap_dance_action_t *)state);
@@ -184,6 +184,10 @@ __attribute__((weak)) void unicode_input_cancel(void) {
     set_mods(unicode_saved_mods); // Reregister previously set mods
 }
 
+// The hex digits of a code point, sent as one string so that they can share reports with SEND_STRING_TURBO
+static char    hex_digits[9];
+static uint8_t hex_digit_count = 0;
+
 // clang-format off
 
 static void send_nibble_wrapper(uint8_t digit) {
@@ -194,16 +198,23 @@ static void send_nibble_wrapper(uint8_t digit) {
         tap_code(kc);
         return;
     }
-    send_nibble(digit);
+    hex_digits[hex_digit_count++] = digit < 10 ? '0' + digit : 'a' + (digit - 10);
 }
 
 // clang-format on
 
+static void send_hex_digits(void) {
+    hex_digits[hex_digit_count] = '\0';
+    send_string(hex_digits);
+    hex_digit_count = 0;
+}
+
 void register_hex(uint16_t hex) {
     for (int i = 3; i >= 0; i--) {
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
         send_nibble_wrapper(digit);
     }
+    send_hex_digits();
 }
 
 void register_hex32(uint32_t hex) {
@@ -222,6 +233,7 @@ void register_hex32(uint32_t hex) {
             onzerostart = false;
         }
     }
+    send_hex_digits();
 }
 
 void register_unicode(uint32_t code_point) {
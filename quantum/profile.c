@@ -0,0 +1,86 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "profile.h"
+#include "timer.h"
+#include "debug.h"
+
+#ifndef PROFILE_MAX_PROBES
+#    define PROFILE_MAX_PROBES 48
+#endif
+
+#ifndef PROFILE_PRINT_INTERVAL
+#    define PROFILE_PRINT_INTERVAL 5000
+#endif
+
+static profile_probe_t probes[PROFILE_MAX_PROBES];
+static uint8_t         probe_count = 0;
+
+__attribute__((weak)) void profile_init(void) {}
+
+__attribute__((weak)) uint32_t profile_timestamp(void) {
+    return timer_read32();
+}
+
+void profile_probe_record(uint8_t *probe, const char *name, uint32_t start) {
+    const uint32_t duration = profile_timestamp() - start;
+
+    if (*probe == PROFILE_PROBE_UNREGISTERED) {
+        // Out of probes, the section is silently dropped from the results
+        if (probe_count >= PROFILE_MAX_PROBES) {
+            return;
+        }
+        *probe                = probe_count++;
+        probes[*probe].name = name;
+        probes[*probe].min  = UINT32_MAX;
+    }
+
+    profile_probe_t *entry = &probes[*probe];
+    entry->count++;
+    entry->total += duration;
+    if (duration < entry->min) {
+        entry->min = duration;
+    }
+    if (duration > entry->max) {
+        entry->max = duration;
+    }
+}
+
+uint8_t profile_probe_count(void) {
+    return probe_count;
+}
+
+const profile_probe_t *profile_probe_get(uint8_t index) {
+    return index < probe_count ? &probes[index] : NULL;
+}
+
+void profile_reset(void) {
+    for (uint8_t i = 0; i < probe_count; ++i) {
+        probes[i].count = 0;
+        probes[i].min   = UINT32_MAX;
+        probes[i].max   = 0;
+        probes[i].total = 0;
+    }
+}
+
+void profile_print(void) {
+    for (uint8_t i = 0; i < probe_count; ++i) {
+        const profile_probe_t *entry = &probes[i];
+        if (entry->count == 0) {
+            continue;
+        }
+        dprintf("profile %s: count %lu, min %lu, avg %lu, max %lu\n", entry->name, (unsigned long)entry->count, (unsigned long)entry->min, (unsigned long)(entry->total / entry->count), (unsigned long)entry->max);
+    }
+}
+
+void profile_task(void) {
+#if PROFILE_PRINT_INTERVAL > 0
+    static uint32_t print_timer = 0;
+
+    if (timer_elapsed32(print_timer) >= PROFILE_PRINT_INTERVAL) {
+        profile_print();
+        profile_reset();
+        print_timer = timer_read32();
+    }
+#endif
+}
@@ -0,0 +1,90 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILE_PROBE_UNREGISTERED 0xFF
+
+/**
+ * @struct Accumulated timings of a single instrumented section of code.
+ */
+typedef struct {
+    const char *name;
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    max;
+    uint64_t    total;
+} profile_probe_t;
+
+/**
+ * Initialises the platform counter used for timestamps.
+ */
+void profile_init(void);
+
+/**
+ * Reads the platform counter: CPU cycles on Cortex-M3 and above, nanoseconds on the test platform, milliseconds otherwise.
+ */
+uint32_t profile_timestamp(void);
+
+#ifdef PROFILE_ENABLE
+
+/**
+ * Accumulates the time elapsed since start into the probe, registering the probe on first use.
+ *
+ * @param probe[in,out] the probe index, initialised to PROFILE_PROBE_UNREGISTERED
+ * @param name[in] the name of the probe, must have static storage
+ * @param start[in] the value of profile_timestamp() when the section was entered
+ */
+void profile_probe_record(uint8_t *probe, const char *name, uint32_t start);
+
+uint8_t                profile_probe_count(void);
+const profile_probe_t *profile_probe_get(uint8_t index);
+void                   profile_reset(void);
+void                   profile_print(void);
+
+/**
+ * Periodically dumps the timings to the console, invoked from the main loop.
+ */
+void profile_task(void);
+
+#    define PROFILE_BEGIN(name)                                            \
+        static uint8_t profile_probe_##name = PROFILE_PROBE_UNREGISTERED; \
+        const uint32_t profile_start_##name = profile_timestamp()
+#    define PROFILE_END(name) profile_probe_record(&profile_probe_##name, #name, profile_start_##name)
+
+/* Invokes a function returning void, recording its duration against a probe of the same name */
+#    define PROFILE_CALL(func, ...) \
+        do {                        \
+            PROFILE_BEGIN(func);    \
+            func(__VA_ARGS__);      \
+            PROFILE_END(func);      \
+        } while (0)
+
+/* Invokes a function returning bool, recording its duration against a probe of the same name */
+#    define PROFILE_CALL_BOOL(func, ...)                    \
+        ({                                                  \
+            PROFILE_BEGIN(func);                            \
+            bool profile_result_##func = func(__VA_ARGS__); \
+            PROFILE_END(func);                              \
+            profile_result_##func;                          \
+        })
+
+#else
+
+#    define PROFILE_BEGIN(name)
+#    define PROFILE_END(name)
+#    define PROFILE_CALL(func, ...) func(__VA_ARGS__)
+#    define PROFILE_CALL_BOOL(func, ...) func(__VA_ARGS__)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,6 +15,7 @@
  */
 
 #include "quantum.h"
+#include "profile.h"
 
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
@@ -204,7 +205,7 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
 bool pre_process_record_quantum(keyrecord_t *record) {
     if (!(
 #ifdef COMBO_ENABLE
-            process_combo(get_record_keycode(record, true), record) &&
+            PROFILE_CALL_BOOL(process_combo, get_record_keycode(record, true), record) &&
 #endif
             true)) {
         return false;
@@ -218,125 +219,210 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/* Core keycode function, hands off handling to other functions,
-    then processes internal quantum keycodes, and then processes
-    ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
-
-    // This is how you use actions here
-    // if (keycode == KC_LEAD) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
+/* An inclusive range of keycodes */
+typedef struct {
+    uint16_t first;
+    uint16_t last;
+} keycode_range_t;
 
-#if defined(SECURE_ENABLE)
-    if (!preprocess_secure(keycode, record)) {
-        return false;
-    }
+typedef struct {
+#ifdef PROFILE_ENABLE
+    const char *name;
 #endif
+    bool (*process)(uint16_t keycode, keyrecord_t *record);
+    // Only the keycodes this handler acts on, or NULL if it observes every key
+    const keycode_range_t *ranges;
+    uint8_t                range_count;
+} process_record_handler_t;
 
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled() && record->event.pressed) {
-        velocikey_accelerate();
-    }
+#ifdef PROFILE_ENABLE
+#    define PROCESS_RECORD_HANDLER_NAME(func) .name = #func,
+#else
+#    define PROCESS_RECORD_HANDLER_NAME(func)
 #endif
 
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
-#endif
+/* A handler which is invoked for every key */
+#define PROCESS_RECORD_HANDLER(func) \
+    { PROCESS_RECORD_HANDLER_NAME(func).process = func, .ranges = NULL, .range_count = 0 }
+/* A handler which lets every key outside the given ranges through untouched, and is only invoked for the keys inside */
+#define PROCESS_RECORD_HANDLER_FOR(func, ...) \
+    { PROCESS_RECORD_HANDLER_NAME(func).process = func, .ranges = (const keycode_range_t[]){__VA_ARGS__}, .range_count = sizeof((const keycode_range_t[]){__VA_ARGS__}) / sizeof(keycode_range_t) }
 
-#ifdef TAP_DANCE_ENABLE
-    preprocess_tap_dance(keycode, record);
+#ifdef KEY_OVERRIDE_ENABLE
+static bool process_key_override_record(uint16_t keycode, keyrecord_t *record) {
+    return process_key_override(keycode, record);
+}
 #endif
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
+#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+static bool process_rgb_record(uint16_t keycode, keyrecord_t *record) {
+    return process_rgb(keycode, record);
+}
 #endif
+
+/**
+ * @brief Keycode handlers, in the order they process a key. Each returns false to stop processing.
+ */
+static const process_record_handler_t process_record_handler_list[] = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    PROCESS_RECORD_HANDLER(process_dynamic_macro),
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_clicky),
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_haptic),
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_record_via, VIA_KEYCODE_RANGES),
 #endif
-            process_record_kb(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_record_kb),
 #if defined(SECURE_ENABLE)
-            process_secure(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_secure),
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_sequencer, SEQUENCER_KEYCODE_RANGES),
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_midi, MIDI_KEYCODE_RANGES),
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_audio, AUDIO_KEYCODE_RANGES),
 #endif
 #if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
-            process_backlight(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_backlight, BACKLIGHT_KEYCODE_RANGES),
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_steno, STENO_KEYCODE_RANGES),
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_music),
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_key_override_record),
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_tap_dance),
 #endif
 #ifdef CAPS_WORD_ENABLE
-            process_caps_word(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_caps_word),
 #endif
 #if defined(UNICODE_COMMON_ENABLE)
-            process_unicode_common(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_unicode_common),
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_leader),
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_printer),
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_auto_shift),
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_dynamic_tapping_term, DYNAMIC_TAPPING_TERM_KEYCODE_RANGES),
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_space_cadet),
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_magic, MAGIC_KEYCODE_RANGES),
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_grave_esc, GRAVE_ESC_KEYCODE_RANGES),
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_rgb_record, RGB_KEYCODE_RANGES),
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_joystick, JOYSTICK_KEYCODE_RANGES),
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+    PROCESS_RECORD_HANDLER_FOR(process_programmable_button, PROGRAMMABLE_BUTTON_KEYCODE_RANGES),
 #endif
-            true)) {
+};
+
+#define PROCESS_RECORD_HANDLER_COUNT (sizeof(process_record_handler_list) / sizeof(process_record_handler_t))
+
+static inline bool keycode_in_ranges(uint16_t keycode, const keycode_range_t *ranges, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (keycode >= ranges[i].first && keycode <= ranges[i].last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Hands the key to each handler in turn, skipping those which only act on other keycodes */
+static bool process_record_handlers(uint16_t keycode, keyrecord_t *record) {
+    for (uint8_t i = 0; i < PROCESS_RECORD_HANDLER_COUNT; i++) {
+        const process_record_handler_t *handler = &process_record_handler_list[i];
+        if (handler->ranges && !keycode_in_ranges(keycode, handler->ranges, handler->range_count)) {
+            continue;
+        }
+
+#ifdef PROFILE_ENABLE
+        static uint8_t probes[PROCESS_RECORD_HANDLER_COUNT] = {[0 ... PROCESS_RECORD_HANDLER_COUNT - 1] = PROFILE_PROBE_UNREGISTERED};
+        const uint32_t start                                = profile_timestamp();
+        const bool     result                               = handler->process(keycode, record);
+        profile_probe_record(&probes[i], handler->name, start);
+        if (!result) {
+            return false;
+        }
+#else
+        if (!handler->process(keycode, record)) {
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+/* Core keycode function, hands off handling to other functions,
+    then processes internal quantum keycodes, and then processes
+    ACTIONs.                                                      */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == KC_LEAD) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#if defined(SECURE_ENABLE)
+    if (!preprocess_secure(keycode, record)) {
+        return false;
+    }
+#endif
+
+#ifdef VELOCIKEY_ENABLE
+    if (velocikey_enabled() && record->event.pressed) {
+        velocikey_accelerate();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    preprocess_tap_dance(keycode, record);
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!PROFILE_CALL_BOOL(process_key_lock, &keycode, record)) {
+        return false;
+    }
+#endif
+
+    if (!process_record_handlers(keycode, record)) {
         return false;
     }
 
@@ -445,6 +531,9 @@ void matrix_init_quantum() {
     matrix_init_kb();
 }
 void matrix_scan_quantum() {
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_COUNT)
+    leader_table_task();
+#endif
     matrix_scan_kb();
 }
 
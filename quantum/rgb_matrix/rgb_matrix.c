@@ -20,6 +20,7 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "profile.h"
 #include <string.h>
 #include <math.h>
 
@@ -431,14 +432,14 @@ void rgb_matrix_task(void) {
             rgb_task_start();
             break;
         case RENDERING:
-            rgb_task_render(effect);
+            PROFILE_CALL(rgb_task_render, effect);
             if (effect) {
                 rgb_matrix_indicators();
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
             }
             break;
         case FLUSHING:
-            rgb_task_flush(effect);
+            PROFILE_CALL(rgb_task_flush, effect);
             break;
         case SYNCING:
             rgb_task_sync();
@@ -446,6 +447,20 @@ void rgb_matrix_task(void) {
     }
 }
 
+uint32_t rgb_matrix_next_deadline(void) {
+    const uint32_t now = timer_read32();
+
+    // Rendering and flushing carry on as soon as possible, only the wait for the next frame can be skipped
+    if (rgb_task_state == SYNCING) {
+        const uint32_t elapsed = sync_timer_elapsed32(g_rgb_timer);
+        if (elapsed < RGB_MATRIX_LED_FLUSH_LIMIT) {
+            return now + (RGB_MATRIX_LED_FLUSH_LIMIT - elapsed);
+        }
+    }
+
+    return now;
+}
+
 void rgb_matrix_indicators(void) {
     rgb_matrix_indicators_kb();
     rgb_matrix_indicators_user();
@@ -126,6 +126,9 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed);
 
 void rgb_matrix_task(void);
 
+// Absolute time (as per timer_read32()) at which rgb_matrix_task() next has work to do
+uint32_t rgb_matrix_next_deadline(void);
+
 // This runs after another backlight effect and replaces
 // colors already set
 void rgb_matrix_indicators(void);
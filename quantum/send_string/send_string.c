@@ -142,6 +142,95 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 // Note: we bit-pack in "reverse" order to optimize loading
 #define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
 
+#ifdef SEND_STRING_TURBO
+/* In turbo mode, the key of the last character of a string is left pressed, and released in the same report as the
+ * key of the next character is pressed. Each report still presses at most one new key, so that the host cannot
+ * reorder the characters. */
+static uint8_t turbo_key  = KC_NO;
+static uint8_t turbo_mods = 0;
+
+/** \brief Releases the key of the last character, and its modifiers
+ */
+static void turbo_release(void) {
+    if (turbo_key != KC_NO) {
+        del_key(turbo_key);
+        del_weak_mods(turbo_mods);
+        send_keyboard_report();
+        turbo_key  = KC_NO;
+        turbo_mods = 0;
+    }
+}
+
+/** \brief Presses the key of a character, releasing the key of the last character in the same report where possible
+ */
+static void turbo_press(uint8_t keycode, uint8_t mods) {
+    if (turbo_key != KC_NO) {
+        del_key(turbo_key);
+        // A key pressed again has to be seen released first, and the last key must not be seen with other modifiers
+        if (keycode == turbo_key || mods != turbo_mods) {
+            send_keyboard_report();
+        }
+    }
+    // Modifiers changed in the same report as a key is pressed apply to that key
+    del_weak_mods(turbo_mods);
+    add_weak_mods(mods);
+    add_key(keycode);
+    send_keyboard_report();
+    turbo_key  = keycode;
+    turbo_mods = mods;
+#    if TAP_CODE_DELAY > 0
+    wait_ms(TAP_CODE_DELAY);
+#    endif
+}
+
+/** \brief Sends a character of a string, leaving its key pressed
+ */
+static void turbo_send_char(char ascii_code) {
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') { // BEL
+        turbo_release();
+        PLAY_SONG(bell_song);
+        return;
+    }
+#    endif
+
+    uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    if (keycode == KC_NO) {
+        return;
+    }
+
+    uint8_t mods = 0;
+    if (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code)) {
+        mods |= MOD_BIT(KC_LEFT_SHIFT);
+    }
+    if (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code)) {
+        mods |= MOD_BIT(KC_RIGHT_ALT);
+    }
+    turbo_press(keycode, mods);
+    if (PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code)) {
+        turbo_press(KC_SPACE, 0);
+    }
+}
+#endif
+
+/** \brief Sends a character of a string, which is left pressed in turbo mode
+ */
+static void send_string_char(char ascii_code) {
+#ifdef SEND_STRING_TURBO
+    turbo_send_char(ascii_code);
+#else
+    send_char(ascii_code);
+#endif
+}
+
+/** \brief Releases the key left pressed by send_string_char(), before anything else is sent or waited for
+ */
+static void send_string_release(void) {
+#ifdef SEND_STRING_TURBO
+    turbo_release();
+#endif
+}
+
 void send_string(const char *string) {
     send_string_with_delay(string, 0);
 }
@@ -151,6 +240,7 @@ void send_string_with_delay(const char *string, uint8_t interval) {
         char ascii_code = *string;
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+            send_string_release();
             ascii_code = *(++string);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -177,25 +267,31 @@ void send_string_with_delay(const char *string, uint8_t interval) {
                     wait_ms(1);
             }
         } else {
-            send_char(ascii_code);
+            send_string_char(ascii_code);
         }
         ++string;
         // interval
-        {
+        if (interval) {
+            send_string_release();
             uint8_t ms = interval;
             while (ms--)
                 wait_ms(1);
         }
     }
+    send_string_release();
 }
 
 void send_char(char ascii_code) {
-#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+#ifdef SEND_STRING_TURBO
+    turbo_send_char(ascii_code);
+    turbo_release();
+#else
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
     if (ascii_code == '\a') { // BEL
         PLAY_SONG(bell_song);
         return;
     }
-#endif
+#    endif
 
     uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
     bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
@@ -218,6 +314,31 @@ void send_char(char ascii_code) {
     if (is_dead) {
         tap_code(KC_SPACE);
     }
+#endif
+}
+
+// The keys packed into the codes below KC_A and after KC_CAPS_LOCK, see SEND_KEYCODES_KEY()
+static const uint8_t send_keycodes_moved_keys[] PROGMEM = {
+    KC_NONUS_BACKSLASH, KC_INTERNATIONAL_1, KC_INTERNATIONAL_2, KC_INTERNATIONAL_3, KC_INTERNATIONAL_4, KC_INTERNATIONAL_5, KC_LANGUAGE_1, KC_LANGUAGE_2, KC_KP_DOT, KC_KP_COMMA,
+};
+
+void send_keycodes_P(const uint8_t *keys, uint8_t count) {
+    while (count--) {
+        const uint8_t packed  = pgm_read_byte(keys++);
+        uint8_t       keycode = packed & 0x3F;
+
+        if (keycode < KC_A) {
+            keycode = pgm_read_byte(&send_keycodes_moved_keys[keycode]);
+        } else if (keycode > KC_CAPS_LOCK) {
+            keycode = pgm_read_byte(&send_keycodes_moved_keys[keycode - KC_CAPS_LOCK - 1 + KC_A]);
+        }
+#ifdef SEND_STRING_TURBO
+        turbo_press(keycode, (packed & 0x80 ? MOD_BIT(KC_RIGHT_ALT) : 0) | (packed & 0x40 ? MOD_BIT(KC_LEFT_SHIFT) : 0));
+#else
+        tap_code16((packed & 0x80 ? QK_RALT : 0) | (packed & 0x40 ? QK_LSFT : 0) | keycode);
+#endif
+    }
+    send_string_release();
 }
 
 void send_dword(uint32_t number) {
@@ -284,6 +405,7 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
         char ascii_code = pgm_read_byte(string);
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+            send_string_release();
             ascii_code = pgm_read_byte(++string);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -310,15 +432,17 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
                     wait_ms(1);
             }
         } else {
-            send_char(ascii_code);
+            send_string_char(ascii_code);
         }
         ++string;
         // interval
-        {
+        if (interval) {
+            send_string_release();
             uint8_t ms = interval;
             while (ms--)
                 wait_ms(1);
         }
     }
+    send_string_release();
 }
 #endif
@@ -44,6 +44,65 @@ extern const uint8_t ascii_to_keycode_lut[128];
     | ((h) ? 1 : 0) << 7 )
 // clang-format on
 
+// clang-format off
+/* SEND_KEYCODES() packs each keycode into a single byte: bit 7 is AltGr (Option on macOS), bit 6 is Shift and bits 0-5
+ * are the key. The keys past KC_CAPS_LOCK that the keymap_extras layouts use are moved into the codes left free below
+ * KC_A and after KC_CAPS_LOCK. There is no bit left for the side of Alt, so LALT(), which the macOS layouts use for
+ * Option, is packed like RALT() and sent as Right Alt. Any other key or modifier does not fit, and fails to build with
+ * an overflow. */
+#define SEND_KEYCODES_KEY(kc) \
+    ( (kc) >= KC_A && (kc) <= KC_CAPS_LOCK ? (kc) \
+    : (kc) == KC_NONUS_BACKSLASH ? 0x00 \
+    : (kc) == KC_INTERNATIONAL_1 ? 0x01 \
+    : (kc) == KC_INTERNATIONAL_2 ? 0x02 \
+    : (kc) == KC_INTERNATIONAL_3 ? 0x03 \
+    : (kc) == KC_INTERNATIONAL_4 ? 0x3A \
+    : (kc) == KC_INTERNATIONAL_5 ? 0x3B \
+    : (kc) == KC_LANGUAGE_1 ? 0x3C \
+    : (kc) == KC_LANGUAGE_2 ? 0x3D \
+    : (kc) == KC_KP_DOT ? 0x3E \
+    : (kc) == KC_KP_COMMA ? 0x3F \
+    : 0x100 )
+#define SEND_KEYCODES_BYTE(kc) \
+    ( ((kc) & ~(QK_RMODS_MIN | QK_LALT | QK_LSFT | 0xFF)) ? 0x100 \
+    : ((kc) & QK_LALT ? 0x80 : 0) | ((kc) & QK_LSFT ? 0x40 : 0) | SEND_KEYCODES_KEY((kc) & 0xFF) )
+
+#define SEND_KEYCODES_PACK_1(kc) SEND_KEYCODES_BYTE(kc)
+#define SEND_KEYCODES_PACK_2(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_1(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_3(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_2(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_4(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_3(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_5(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_4(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_6(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_5(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_7(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_6(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_8(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_7(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_9(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_8(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_10(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_9(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_11(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_10(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_12(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_11(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_13(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_12(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_14(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_13(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_15(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_14(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_16(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_15(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_17(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_16(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_18(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_17(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_19(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_18(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_20(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_19(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_21(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_20(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_22(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_21(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_23(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_22(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_24(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_23(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_25(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_24(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_26(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_25(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_27(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_26(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_28(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_27(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_29(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_28(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_30(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_29(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_31(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_30(__VA_ARGS__)
+#define SEND_KEYCODES_PACK_32(kc, ...) SEND_KEYCODES_BYTE(kc), SEND_KEYCODES_PACK_31(__VA_ARGS__)
+#define SEND_KEYCODES_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, n, ...) SEND_KEYCODES_PACK_##n
+#define SEND_KEYCODES_PACK(...) SEND_KEYCODES_SELECT(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)(__VA_ARGS__)
+// clang-format on
+
 /**
  * \brief Type out a string of ASCII characters.
  *
@@ -70,6 +129,18 @@ void send_string_with_delay(const char *string, uint8_t interval);
  */
 void send_char(char ascii_code);
 
+/**
+ * \brief Type out a PROGMEM array of keycodes packed by `SEND_KEYCODES()`.
+ *
+ * Each key is tapped along with Shift and AltGr where it was packed with them, Left Alt is sent as AltGr too. Unlike a
+ * string, the keys are not looked up in the ASCII tables, so the keycodes of any keymap_extras layout can be used,
+ * including those for characters that are not in ASCII. Dead keys are not followed by a space.
+ *
+ * \param keys The packed keys to type out.
+ * \param count The number of keys.
+ */
+void send_keycodes_P(const uint8_t *keys, uint8_t count);
+
 /**
  * \brief Type out an eight digit (unsigned 32-bit) hexadecimal value.
  *
@@ -149,4 +220,16 @@ void send_string_with_delay_P(const char *string, uint8_t interval);
  */
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
 
+/**
+ * \brief Types out up to 32 keycodes, which are packed into a byte each and stored in PROGMEM.
+ *
+ * For example, `SEND_KEYCODES(S(FR_C), FR_A, FR_F, FR_EACU)` types "Café" with the French layout. Only Shift and AltGr
+ * can be packed with a key, and `LALT()` is packed as AltGr, so it is sent as Right Alt.
+ */
+#define SEND_KEYCODES(...)                                                                      \
+    do {                                                                                        \
+        static const uint8_t send_keycodes_array[] PROGMEM = {SEND_KEYCODES_PACK(__VA_ARGS__)}; \
+        send_keycodes_P(send_keycodes_array, sizeof(send_keycodes_array));                      \
+    } while (0)
+
 /** \} */
@@ -0,0 +1,127 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "sof_sync.h"
+#include "host.h"
+#include "timer.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+
+#ifndef USB_POLLING_INTERVAL_MS
+#    define USB_POLLING_INTERVAL_MS 1
+#endif
+
+// How many frames ahead of the poll the held report is handed to the host driver
+#ifndef SOF_SYNC_LEAD_FRAMES
+#    define SOF_SYNC_LEAD_FRAMES 1
+#endif
+
+#if SOF_SYNC_LEAD_FRAMES < 1
+#    error "SOF_SYNC_LEAD_FRAMES must be at least 1"
+#endif
+
+// Reports are handed over at most SOF_SYNC_LEAD_FRAMES before a poll, so holding them needs at least one frame more
+// between polls. With faster polling every report would be sent right away.
+#if USB_POLLING_INTERVAL_MS < SOF_SYNC_LEAD_FRAMES + 2
+#    error "SOF_SYNC_ENABLE needs a USB_POLLING_INTERVAL_MS of at least SOF_SYNC_LEAD_FRAMES + 2, i.e. 3 with the default lead"
+#endif
+
+// Without a start of frame for this many milliseconds, the host is not polling and reports are sent right away
+#ifndef SOF_SYNC_TIMEOUT
+#    define SOF_SYNC_TIMEOUT 3
+#endif
+
+// Updated from the USB interrupts
+static volatile uint16_t frame_count   = 0;
+static volatile uint16_t read_frame    = 0;
+static volatile bool     read_seen     = false;
+static volatile uint8_t  poll_interval = USB_POLLING_INTERVAL_MS;
+
+// When the main loop first saw the current frame, timers cannot be read from interrupts on all platforms
+static uint16_t seen_frame_count = 0;
+static uint32_t frame_time       = 0;
+
+static report_keyboard_t held_report;
+static report_keyboard_t previous_report;
+static bool              has_held_report = false;
+
+void sof_sync_start_of_frame(void) {
+    frame_count++;
+}
+
+void sof_sync_keyboard_read(void) {
+    // Hosts may poll faster than bInterval asks for, reads are then closer together
+    const uint16_t frames = frame_count - read_frame;
+    if (read_seen && frames > 0 && frames < poll_interval) {
+        poll_interval = frames;
+    }
+    read_frame = frame_count;
+    read_seen  = true;
+}
+
+void sof_sync_reset(void) {
+    read_seen     = false;
+    poll_interval = USB_POLLING_INTERVAL_MS;
+}
+
+static bool is_synced(void) {
+    const uint32_t now = timer_read32();
+    if (frame_count != seen_frame_count) {
+        seen_frame_count = frame_count;
+        frame_time       = now;
+    }
+    return read_seen && TIMER_DIFF_32(now, frame_time) < SOF_SYNC_TIMEOUT;
+}
+
+// 0 in the frame the host is expected to poll in
+static uint8_t frames_until_poll(void) {
+    const uint8_t since_poll = (uint16_t)(frame_count - read_frame) % poll_interval;
+    return since_poll ? poll_interval - since_poll : 0;
+}
+
+static void send_held_report(void) {
+    host_driver_t *driver = host_get_driver();
+    if (driver) {
+        (*driver->send_keyboard)(&held_report);
+#ifdef LATENCY_TRACE_ENABLE
+        latency_trace_report_sent(&held_report);
+#endif
+    }
+    previous_report = held_report;
+    has_held_report = false;
+}
+
+void sof_sync_send_keyboard(report_keyboard_t *report) {
+    // The held report goes out first if the new one would lose any of its changes
+    if (has_held_report && !can_replace_keyboard_report(&previous_report, &held_report, report)) {
+        send_held_report();
+    }
+
+    held_report     = *report;
+    has_held_report = true;
+    sof_sync_task();
+}
+
+void sof_sync_task(void) {
+    // Checked on every scan, so that frames are timestamped as soon as possible
+    const bool synced = is_synced();
+    if (has_held_report && (!synced || frames_until_poll() <= SOF_SYNC_LEAD_FRAMES)) {
+        send_held_report();
+    }
+}
+
+bool sof_sync_next_deadline(uint32_t *deadline) {
+    // Nothing to hand over, the next report wakes the main loop anyway
+    if (!has_held_report || !is_synced()) {
+        return false;
+    }
+
+    // The start of the next lead in to a poll, at least one frame away
+    int16_t frames = (int16_t)frames_until_poll() - SOF_SYNC_LEAD_FRAMES;
+    while (frames < 1) {
+        frames += poll_interval;
+    }
+    *deadline = frame_time + frames;
+    return true;
+}
@@ -0,0 +1,52 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Records the start of a USB frame. Called by the protocol from its start of frame interrupt.
+ */
+void sof_sync_start_of_frame(void);
+
+/**
+ * Records that the host has read a keyboard report, which gives the phase of its polling. Called by the protocol from
+ * the IN completion interrupt of the keyboard endpoint.
+ */
+void sof_sync_keyboard_read(void);
+
+/**
+ * Forgets the polling of the host, which starts over once it reads a report again. Called by the protocol when the
+ * device is reset or configured.
+ */
+void sof_sync_reset(void);
+
+/**
+ * Hands a keyboard report to the host driver, or holds it until the frame before the next poll of the host. Changes
+ * made while a report is held are merged into it, as long as no key press or release is lost.
+ */
+void sof_sync_send_keyboard(report_keyboard_t *report);
+
+/**
+ * Hands the held report to the host driver once the next poll is close. Called from keyboard_task().
+ */
+void sof_sync_task(void);
+
+/**
+ * Works out when the next report has to be handed to the host driver, so that scanning ends right before the poll.
+ *
+ * @param deadline[out] the absolute time of the deadline -- equivalent time-space as timer_read32()
+ * @return true if a report is held back and the host polling is being tracked
+ */
+bool sof_sync_next_deadline(uint32_t *deadline);
+
+#ifdef __cplusplus
+}
+#endif
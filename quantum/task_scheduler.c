@@ -0,0 +1,97 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "task_scheduler.h"
+#include "timer.h"
+#include "debug.h"
+
+#ifndef TASK_SCHEDULER_TIMESTAMP
+// Clock used to measure task durations, profiling builds use the finer-grained profile counter
+#    ifdef PROFILE_ENABLE
+#        include "profile.h"
+#        define TASK_SCHEDULER_TIMESTAMP() profile_timestamp()
+#    else
+#        define TASK_SCHEDULER_TIMESTAMP() timer_read32()
+#    endif
+#endif
+
+static inline int32_t time_until(uint32_t deadline, uint32_t now) {
+    return (int32_t)TIMER_DIFF_32(deadline, now);
+}
+
+void task_scheduler_run(const scheduled_task_t *tasks, scheduled_task_state_t *states, uint8_t task_count, bool busy) {
+    const uint32_t now = timer_read32();
+
+    for (uint8_t i = 0; i < task_count; ++i) {
+        const scheduled_task_t *task  = &tasks[i];
+        scheduled_task_state_t *state = &states[i];
+
+        if (task->period || task->next_deadline) {
+            int32_t lateness = -time_until(state->next_run, now);
+
+            // Not due yet
+            if (lateness < 0) {
+                continue;
+            }
+
+            // Give the scan loop priority while keys are changing, unless the task is already a full period late
+            if (busy && task->priority == TASK_PRIORITY_LOW && lateness < task->period) {
+                continue;
+            }
+        }
+
+        const uint32_t start = TASK_SCHEDULER_TIMESTAMP();
+        task->task();
+        const uint32_t duration = TASK_SCHEDULER_TIMESTAMP() - start;
+
+        state->run_count++;
+        state->last_duration = duration;
+        if (duration > state->max_duration) {
+            state->max_duration = duration;
+        }
+
+        // The hook may postpone the next run past the period, e.g. while an animation waits for its next frame
+        state->next_run = now + task->period;
+        if (task->next_deadline) {
+            uint32_t deadline = task->next_deadline();
+            if (time_until(deadline, state->next_run) > 0) {
+                state->next_run = deadline;
+            }
+        }
+    }
+}
+
+uint32_t task_scheduler_next_deadline(const scheduled_task_t *tasks, const scheduled_task_state_t *states, uint8_t task_count) {
+    const uint32_t now      = timer_read32();
+    uint32_t       deadline = now + UINT16_MAX;
+
+    for (uint8_t i = 0; i < task_count; ++i) {
+        // Tasks without a period or hook need to run on every iteration
+        if (!tasks[i].period && !tasks[i].next_deadline) {
+            return now;
+        }
+        if (time_until(states[i].next_run, deadline) < 0) {
+            deadline = states[i].next_run;
+        }
+    }
+
+    return time_until(deadline, now) < 0 ? now : deadline;
+}
+
+void task_scheduler_reset_stats(scheduled_task_state_t *states, uint8_t task_count) {
+    for (uint8_t i = 0; i < task_count; ++i) {
+        states[i].run_count     = 0;
+        states[i].last_duration = 0;
+        states[i].max_duration  = 0;
+    }
+}
+
+void task_scheduler_print_stats(const scheduled_task_t *tasks, const scheduled_task_state_t *states, uint8_t task_count) {
+    for (uint8_t i = 0; i < task_count; ++i) {
+#ifdef TASK_SCHEDULER_NAMES
+        dprintf("task %s: runs %lu, last %lu, max %lu\n", tasks[i].name, (unsigned long)states[i].run_count, (unsigned long)states[i].last_duration, (unsigned long)states[i].max_duration);
+#else
+        dprintf("task %u: runs %lu, last %lu, max %lu\n", i, (unsigned long)states[i].run_count, (unsigned long)states[i].last_duration, (unsigned long)states[i].max_duration);
+#endif
+    }
+}
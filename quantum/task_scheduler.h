@@ -0,0 +1,90 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Task names cost a string per table entry, so they are only kept for builds that report them */
+#if defined(PROFILE_ENABLE) || defined(DEBUG_TASK_SCHEDULER)
+#    define TASK_SCHEDULER_NAMES
+#endif
+
+/**
+ * @enum Priority of a scheduled task.
+ *
+ * TASK_PRIORITY_HIGH tasks run every time they are due.
+ * TASK_PRIORITY_NORMAL tasks run every time they are due.
+ * TASK_PRIORITY_LOW tasks that are due are postponed while the matrix is busy, until they are a full period late.
+ */
+typedef enum {
+    TASK_PRIORITY_HIGH,
+    TASK_PRIORITY_NORMAL,
+    TASK_PRIORITY_LOW,
+} task_priority_t;
+
+/**
+ * @typedef Optional hook used by a task to postpone its next invocation beyond its period.
+ * @return the absolute time the task next needs to run -- equivalent time-space as timer_read32()
+ */
+typedef uint32_t (*task_deadline_callback)(void);
+
+/**
+ * @struct Static description of a task executed by the scheduler.
+ */
+typedef struct {
+#ifdef TASK_SCHEDULER_NAMES
+    const char *name;
+#endif
+    void (*task)(void);
+    task_deadline_callback next_deadline;
+    uint16_t               period;
+    task_priority_t        priority;
+} scheduled_task_t;
+
+/**
+ * @struct Runtime state and statistics of a scheduled task.
+ */
+typedef struct {
+    uint32_t next_run;
+    uint32_t run_count;
+    uint32_t last_duration;
+    uint32_t max_duration;
+} scheduled_task_state_t;
+
+/**
+ * Executes all tasks in the table that are due, in table order.
+ *
+ * @param tasks[in] the table of tasks
+ * @param states[in,out] the runtime state of each task, same length as tasks
+ * @param task_count[in] the number of tasks in the table
+ * @param busy[in] true if the current loop iteration processed key events, postponing low priority tasks
+ */
+void task_scheduler_run(const scheduled_task_t *tasks, scheduled_task_state_t *states, uint8_t task_count, bool busy);
+
+/**
+ * Works out the earliest time any task in the table needs to run.
+ *
+ * @return the absolute time of the next deadline -- equivalent time-space as timer_read32()
+ */
+uint32_t task_scheduler_next_deadline(const scheduled_task_t *tasks, const scheduled_task_state_t *states, uint8_t task_count);
+
+/**
+ * Clears the run count and duration statistics of every task in the table.
+ */
+void task_scheduler_reset_stats(scheduled_task_state_t *states, uint8_t task_count);
+
+/**
+ * Dumps the run count and duration statistics of every task in the table to the console.
+ */
+void task_scheduler_print_stats(const scheduled_task_t *tasks, const scheduled_task_state_t *states, uint8_t task_count);
+
+//------------------------------------
+// Main loop tasks, provided by keyboard.c when TASK_SCHEDULER_ENABLE is set
+//------------------------------------
+
+uint8_t                       get_keyboard_task_count(void);
+const scheduled_task_t *      get_keyboard_task(uint8_t index);
+const scheduled_task_state_t *get_keyboard_task_state(uint8_t index);
+uint32_t                      keyboard_task_next_deadline(void);
@@ -0,0 +1,6 @@
+task_scheduler_DEFS := -DNO_DEBUG
+
+task_scheduler_SRC := \
+	$(QUANTUM_PATH)/task_scheduler/tests/task_scheduler_tests.cpp \
+	$(QUANTUM_PATH)/task_scheduler.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
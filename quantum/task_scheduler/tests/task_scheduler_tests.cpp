@@ -0,0 +1,171 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "task_scheduler.h"
+}
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+static uint32_t every_loop_runs;
+static uint32_t periodic_runs;
+static uint32_t lighting_runs;
+static uint32_t hooked_runs;
+static uint32_t hooked_deadline;
+
+static void every_loop_task(void) {
+    every_loop_runs++;
+}
+static void periodic_task(void) {
+    periodic_runs++;
+}
+static void lighting_task(void) {
+    lighting_runs++;
+}
+static void hooked_task(void) {
+    hooked_runs++;
+}
+static uint32_t hooked_next_deadline(void) {
+    return hooked_deadline;
+}
+
+static const scheduled_task_t periodic_tasks[] = {
+    {.task = every_loop_task, .next_deadline = NULL, .period = 0, .priority = TASK_PRIORITY_HIGH},
+    {.task = periodic_task, .next_deadline = NULL, .period = 5, .priority = TASK_PRIORITY_NORMAL},
+    {.task = lighting_task, .next_deadline = NULL, .period = 10, .priority = TASK_PRIORITY_LOW},
+};
+
+static const scheduled_task_t hooked_tasks[] = {
+    {.task = periodic_task, .next_deadline = NULL, .period = 20, .priority = TASK_PRIORITY_NORMAL},
+    {.task = hooked_task, .next_deadline = hooked_next_deadline, .period = 1, .priority = TASK_PRIORITY_LOW},
+};
+
+#define TASK_COUNT(tasks) (sizeof(tasks) / sizeof(tasks[0]))
+
+class TaskScheduler : public ::testing::Test {
+   protected:
+    scheduled_task_state_t states[3];
+
+    void SetUp() override {
+        set_time(0);
+        memset(states, 0, sizeof(states));
+        every_loop_runs = 0;
+        periodic_runs   = 0;
+        lighting_runs   = 0;
+        hooked_runs     = 0;
+        hooked_deadline = 0;
+    }
+
+    void run_for(const scheduled_task_t *tasks, uint8_t count, uint32_t ms, bool busy) {
+        for (uint32_t t = 0; t < ms; t++) {
+            task_scheduler_run(tasks, states, count, busy);
+            advance_time(1);
+        }
+    }
+};
+
+TEST_F(TaskScheduler, tasks_run_once_per_period) {
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 100, false);
+
+    EXPECT_EQ(every_loop_runs, 100);
+    EXPECT_EQ(periodic_runs, 20);
+    EXPECT_EQ(lighting_runs, 10);
+    EXPECT_EQ(states[0].run_count, 100);
+    EXPECT_EQ(states[1].run_count, 20);
+    EXPECT_EQ(states[2].run_count, 10);
+}
+
+TEST_F(TaskScheduler, periods_count_from_the_last_run) {
+    task_scheduler_run(periodic_tasks, states, TASK_COUNT(periodic_tasks), false);
+    EXPECT_EQ(periodic_runs, 1);
+
+    // Running late does not make up for the missed runs
+    advance_time(23);
+    task_scheduler_run(periodic_tasks, states, TASK_COUNT(periodic_tasks), false);
+    EXPECT_EQ(periodic_runs, 2);
+    task_scheduler_run(periodic_tasks, states, TASK_COUNT(periodic_tasks), false);
+    EXPECT_EQ(periodic_runs, 2);
+
+    advance_time(4);
+    task_scheduler_run(periodic_tasks, states, TASK_COUNT(periodic_tasks), false);
+    EXPECT_EQ(periodic_runs, 2);
+    advance_time(1);
+    task_scheduler_run(periodic_tasks, states, TASK_COUNT(periodic_tasks), false);
+    EXPECT_EQ(periodic_runs, 3);
+}
+
+TEST_F(TaskScheduler, low_priority_tasks_are_postponed_while_busy) {
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 1, false);
+    EXPECT_EQ(lighting_runs, 1);
+
+    // Due at 10ms, but postponed until it is a full period late
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 19, true);
+    EXPECT_EQ(lighting_runs, 1);
+    EXPECT_EQ(every_loop_runs, 20);
+    EXPECT_EQ(periodic_runs, 4);
+
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 1, true);
+    EXPECT_EQ(lighting_runs, 2);
+
+    // Runs as soon as it is due again once the matrix settles
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 9, false);
+    EXPECT_EQ(lighting_runs, 2);
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 1, false);
+    EXPECT_EQ(lighting_runs, 3);
+}
+
+TEST_F(TaskScheduler, busy_postpones_only_low_priority_tasks) {
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 100, true);
+
+    EXPECT_EQ(every_loop_runs, 100);
+    EXPECT_EQ(periodic_runs, 20);
+    EXPECT_EQ(lighting_runs, 5);
+}
+
+TEST_F(TaskScheduler, next_deadline_is_now_with_every_loop_tasks) {
+    set_time(1000);
+    run_for(periodic_tasks, TASK_COUNT(periodic_tasks), 1, false);
+
+    EXPECT_EQ(task_scheduler_next_deadline(periodic_tasks, states, TASK_COUNT(periodic_tasks)), 1001);
+}
+
+TEST_F(TaskScheduler, next_deadline_is_the_earliest_task) {
+    set_time(1000);
+    hooked_deadline = 1050;
+    task_scheduler_run(hooked_tasks, states, TASK_COUNT(hooked_tasks), false);
+    EXPECT_EQ(periodic_runs, 1);
+    EXPECT_EQ(hooked_runs, 1);
+
+    // The hook postpones its task past its own period
+    EXPECT_EQ(states[1].next_run, 1050);
+    EXPECT_EQ(task_scheduler_next_deadline(hooked_tasks, states, TASK_COUNT(hooked_tasks)), 1020);
+
+    run_for(hooked_tasks, TASK_COUNT(hooked_tasks), 30, false);
+    EXPECT_EQ(periodic_runs, 2);
+    EXPECT_EQ(hooked_runs, 1);
+    EXPECT_EQ(task_scheduler_next_deadline(hooked_tasks, states, TASK_COUNT(hooked_tasks)), 1040);
+
+    // A hook returning a time before the period does not bring the task forward
+    hooked_deadline = 0;
+    run_for(hooked_tasks, TASK_COUNT(hooked_tasks), 21, false);
+    EXPECT_EQ(hooked_runs, 2);
+    EXPECT_EQ(states[1].next_run, 1051);
+}
+
+TEST_F(TaskScheduler, next_deadline_never_reports_the_past) {
+    set_time(1000);
+    hooked_deadline = 1050;
+    task_scheduler_run(hooked_tasks, states, TASK_COUNT(hooked_tasks), false);
+
+    set_time(2000);
+    EXPECT_EQ(task_scheduler_next_deadline(hooked_tasks, states, TASK_COUNT(hooked_tasks)), 2000);
+}
+
+TEST_F(TaskScheduler, next_deadline_is_capped_when_nothing_is_due) {
+    EXPECT_EQ(task_scheduler_next_deadline(hooked_tasks, states, 0), UINT16_MAX);
+}
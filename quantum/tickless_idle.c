@@ -0,0 +1,28 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "tickless_idle.h"
+#include "deadline.h"
+#include "timer.h"
+
+// How long the core may sleep without anything being due, which bounds the latency of matrix scanning and of any
+// polled task. Raise it only if the matrix calls tickless_idle_wake() from a pin change interrupt.
+#ifndef TICKLESS_IDLE_POLL_INTERVAL
+#    define TICKLESS_IDLE_POLL_INTERVAL 1
+#endif
+
+// Platforms without a sleep implementation keep spinning
+__attribute__((weak)) void tickless_idle_sleep(uint32_t ms) {}
+__attribute__((weak)) void tickless_idle_wake(void) {}
+
+uint32_t tickless_idle_next_deadline(void) {
+    return next_deadline(TICKLESS_IDLE_POLL_INTERVAL);
+}
+
+void tickless_idle_task(void) {
+    const int32_t remaining = (int32_t)TIMER_DIFF_32(tickless_idle_next_deadline(), timer_read32());
+
+    if (remaining > 0) {
+        tickless_idle_sleep(remaining);
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "deadline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Works out when the main loop next has something to do: a scheduled task, a tapping, combo, tap dance or one shot
+ * timeout, a deferred execution, or the next matrix poll. See next_deadline().
+ *
+ * @return the absolute time of the next deadline -- equivalent time-space as timer_read32()
+ */
+uint32_t tickless_idle_next_deadline(void);
+
+/**
+ * Puts the core to sleep until the next deadline, invoked at the end of each main loop iteration.
+ */
+void tickless_idle_task(void);
+
+/**
+ * Platform specific: sleeps for up to the given number of milliseconds, or until tickless_idle_wake() is called.
+ */
+void tickless_idle_sleep(uint32_t ms);
+
+/**
+ * Platform specific: ends the current sleep early. Intended to be called from interrupt handlers, for example a matrix
+ * pin change interrupt.
+ */
+void tickless_idle_wake(void);
+
+#ifdef __cplusplus
+}
+#endif
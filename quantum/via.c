@@ -51,6 +51,9 @@
 #include "eeprom.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#ifdef KEYSTROKE_TRACE_ENABLE
+#    include "keystroke_trace.h"
+#endif
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -199,6 +202,11 @@ bool process_record_via(uint16_t keycode, keyrecord_t *record) {
 // See raw_hid_receive() implementation.
 // DO NOT call raw_hid_send() in the override function.
 __attribute__((weak)) void raw_hid_receive_kb(uint8_t *data, uint8_t length) {
+#ifdef KEYSTROKE_TRACE_ENABLE
+    if (keystroke_trace_raw_hid_receive(data, length)) {
+        return;
+    }
+#endif
     uint8_t *command_id = &(data[0]);
     *command_id         = id_unhandled;
 }
@@ -165,5 +165,8 @@ uint32_t via_get_layout_options(void);
 void     via_set_layout_options(uint32_t value);
 void     via_set_layout_options_kb(uint32_t value);
 
+// FN_MO13, FN_MO23 and the macro keys
+#define VIA_KEYCODE_RANGES {FN_MO13, MACRO15}
+
 // Called by QMK core to process VIA-specific keycodes.
 bool process_record_via(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,137 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "background_matrix_scan.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+class BackgroundMatrixScan : public TestFixture {
+   public:
+    /* Stands in for the scan timer interrupt, which fires independently of the main loop */
+    void simulate_scan_interrupt() {
+        background_matrix_scan_task();
+    }
+};
+
+TEST_F(BackgroundMatrixScan, keys_are_only_seen_once_scanned) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    key.press();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    simulate_scan_interrupt();
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key.release();
+    simulate_scan_interrupt();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(BackgroundMatrixScan, tap_between_main_loop_iterations_is_not_lost) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    key.press();
+    simulate_scan_interrupt();
+    advance_time(5);
+    key.release();
+    simulate_scan_interrupt();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(BackgroundMatrixScan, events_keep_the_time_they_were_scanned_at) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_hold_key});
+
+    // Held past the tapping term, but the main loop only catches up after the release
+    mod_tap_hold_key.press();
+    simulate_scan_interrupt();
+    advance_time(TAPPING_TERM + 50);
+    mod_tap_hold_key.release();
+    simulate_scan_interrupt();
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(BackgroundMatrixScan, changes_wait_for_the_next_scan_while_the_queue_is_full) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 0, 1, KC_E);
+    auto       key_f = KeymapKey(0, 1, 1, KC_F);
+
+    std::vector<KeymapKey> keys = {key_a, key_b, key_c, key_d, key_e, key_f};
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e, key_f});
+
+    // Six changes, but only room for KEY_EVENT_QUEUE_SIZE of them
+    for (auto &key : keys) {
+        key.press();
+    }
+    simulate_scan_interrupt();
+    simulate_scan_interrupt();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    simulate_scan_interrupt();
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Releases are held back the same way
+    for (auto &key : keys) {
+        key.release();
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    simulate_scan_interrupt();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    simulate_scan_interrupt();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -15,4 +15,7 @@
 
 # --------------------------------------------------------------------------------
 # Keep this file, even if it is empty, as a marker that this folder contains tests
-# --------------------------------------------------------------------------------
\ No newline at end of file
+# --------------------------------------------------------------------------------
+
+# Lets idle_for() skip the scans where nothing is due
+TEST_VIRTUAL_CLOCK = yes
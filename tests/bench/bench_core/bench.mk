@@ -0,0 +1,12 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains benchmarks
+# --------------------------------------------------------------------------------
+
+NKRO_ENABLE = yes
+
+# For hsv_to_rgb(), and the keyboard report functions to compare against
+SRC += $(QUANTUM_DIR)/color.c \
+	tests/test_common/keyboard_report_reference.c
@@ -0,0 +1,213 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_benchmark.hpp"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "color.h"
+#include "host.h"
+#include "keyboard_report_reference.h"
+#include "keycode_config.h"
+#include "report.h"
+}
+
+/* key_event() has its designators out of order for C++ */
+static keyevent_t key_event(uint8_t row, uint8_t col, bool pressed) {
+    return (keyevent_t){.key = {.col = col, .row = row}, .pressed = pressed, .time = (uint16_t)(timer_read() | 1)};
+}
+
+class BenchCore : public TestFixture {
+   public:
+    void SetUp() override {
+        // Reports go nowhere, so that only the firmware is measured
+        saved_driver = host_get_driver();
+        host_set_driver(nullptr);
+    }
+
+    void TearDown() override {
+        host_set_driver(saved_driver);
+    }
+
+    /* Maps every position on every layer, KC_NO on the base layer and KC_TRNS above, except for the given keys */
+    void fill_keymap(std::initializer_list<KeymapKey> keys, uint8_t layer_count) {
+        set_keymap(keys);
+        for (uint8_t layer = 0; layer < layer_count; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    if (!find_key(layer, (keypos_t){.col = col, .row = row})) {
+                        add_key(KeymapKey(layer, col, row, layer == 0 ? KC_NO : KC_TRNS));
+                    }
+                }
+            }
+        }
+    }
+
+   private:
+    host_driver_t *saved_driver;
+};
+
+TEST_F(BenchCore, action_exec_plain_key) {
+    fill_keymap({KeymapKey(0, 0, 0, KC_A)}, 1);
+
+    benchmark([] {
+        action_exec(key_event(0, 0, true));
+        action_exec(key_event(0, 0, false));
+    });
+}
+
+TEST_F(BenchCore, action_exec_layer_key) {
+    fill_keymap({KeymapKey(0, 0, 0, MO(1))}, 4);
+
+    benchmark([] {
+        action_exec(key_event(0, 0, true));
+        action_exec(key_event(0, 0, false));
+    });
+}
+
+TEST_F(BenchCore, layer_switch_get_layer) {
+    fill_keymap({KeymapKey(0, 9, 3, KC_A)}, 4);
+    layer_state_set(0b1110);
+
+    uint8_t position = 0;
+    benchmark([&] {
+        // Walks the matrix, each key falling through the transparent layers
+        layer_switch_get_layer((keypos_t){.col = (uint8_t)(position % MATRIX_COLS), .row = (uint8_t)(position / MATRIX_COLS)});
+        position = (position + 1) % (MATRIX_ROWS * MATRIX_COLS);
+    });
+
+    layer_clear();
+}
+
+TEST_F(BenchCore, process_record_quantum) {
+    fill_keymap({KeymapKey(0, 0, 0, KC_A)}, 1);
+    keyrecord_t press   = {.event = key_event(0, 0, true)};
+    keyrecord_t release = {.event = key_event(0, 0, false)};
+
+    benchmark([&] {
+        process_record_quantum(&press);
+        process_record_quantum(&release);
+    });
+}
+
+static const uint8_t typed_keys[] = {KC_A, KC_S, KC_D, KC_F, KC_J, KC_K};
+
+static void add_and_delete_keys(report_keyboard_t *report) {
+    for (uint8_t key : typed_keys) {
+        add_key_to_report(report, key);
+    }
+    for (uint8_t key : typed_keys) {
+        del_key_from_report(report, key);
+    }
+}
+
+static void reference_add_and_delete_keys(report_keyboard_t *report) {
+    for (uint8_t key : typed_keys) {
+        reference_add_key_to_report(report, key);
+    }
+    for (uint8_t key : typed_keys) {
+        reference_del_key_from_report(report, key);
+    }
+}
+
+/* The keyboard report benchmarks come in pairs, the second one running the byte by byte functions report.c used to
+ * have. They use the shared keyboard_report, which is the one send_keyboard_report() checks. */
+
+TEST_F(BenchCore, add_and_del_key_6kro) {
+    benchmark([] { add_and_delete_keys(keyboard_report); });
+}
+
+TEST_F(BenchCore, add_and_del_key_6kro_reference) {
+    benchmark([] { reference_add_and_delete_keys(keyboard_report); });
+}
+
+TEST_F(BenchCore, is_key_pressed_6kro) {
+    add_key_to_report(keyboard_report, KC_A);
+    add_key_to_report(keyboard_report, KC_S);
+    volatile bool sink;
+
+    uint8_t key = 0;
+    benchmark([&] { sink = is_key_pressed(keyboard_report, KC_A + (key++ & 31)); });
+    (void)sink;
+    clear_keys_from_report(keyboard_report);
+}
+
+TEST_F(BenchCore, is_key_pressed_6kro_reference) {
+    add_key_to_report(keyboard_report, KC_A);
+    add_key_to_report(keyboard_report, KC_S);
+    volatile bool sink;
+
+    uint8_t key = 0;
+    benchmark([&] { sink = reference_is_key_pressed(keyboard_report, KC_A + (key++ & 31)); });
+    (void)sink;
+    clear_keys_from_report(keyboard_report);
+}
+
+TEST_F(BenchCore, add_and_del_key_nkro) {
+    keymap_config.nkro = true;
+
+    benchmark([] { add_and_delete_keys(keyboard_report); });
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, add_and_del_key_nkro_reference) {
+    keymap_config.nkro = true;
+
+    benchmark([] { reference_add_and_delete_keys(keyboard_report); });
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, has_anykey_nkro) {
+    keymap_config.nkro = true;
+    volatile uint8_t sink;
+
+    // Nothing pressed is the slowest case for a scan, and the most common one
+    benchmark([&] { sink = has_anykey(keyboard_report); });
+    (void)sink;
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, has_anykey_nkro_reference) {
+    keymap_config.nkro = true;
+    volatile uint8_t sink;
+
+    benchmark([&] { sink = reference_has_anykey(keyboard_report); });
+    (void)sink;
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, get_first_key_nkro) {
+    keymap_config.nkro = true;
+    add_key_to_report(keyboard_report, KC_UP);
+    volatile uint8_t sink;
+
+    benchmark([&] { sink = get_first_key(keyboard_report); });
+    (void)sink;
+    clear_keys_from_report(keyboard_report);
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, get_first_key_nkro_reference) {
+    keymap_config.nkro = true;
+    add_key_to_report(keyboard_report, KC_UP);
+    volatile uint8_t sink;
+
+    benchmark([&] { sink = reference_get_first_key(keyboard_report); });
+    (void)sink;
+    clear_keys_from_report(keyboard_report);
+    keymap_config.nkro = false;
+}
+
+TEST_F(BenchCore, hsv_to_rgb) {
+    uint8_t          hue = 0;
+    volatile uint8_t sink;
+
+    benchmark([&] {
+        RGB rgb = hsv_to_rgb((HSV){.h = hue++, .s = 255, .v = 200});
+        sink    = rgb.r ^ rgb.g ^ rgb.b;
+    });
+    (void)sink;
+}
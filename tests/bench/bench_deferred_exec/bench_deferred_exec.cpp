@@ -0,0 +1,49 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include "test_benchmark.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+}
+
+static uint32_t noop_callback(uint32_t trigger_time, void *cb_arg) {
+    return 0;
+}
+
+class BenchDeferredExec : public ::testing::Test {
+   protected:
+    static constexpr size_t table_count = 250;
+    deferred_executor_t     table[table_count];
+
+    void SetUp() override {
+        std::fill(std::begin(table), std::end(table), deferred_executor_t{});
+    }
+
+    /* Leaves one slot free, with pseudo-random but deterministic delays */
+    void fill_table() {
+        for (size_t i = 0; i < table_count - 1; i++) {
+            defer_exec_advanced(table, table_count, 1 + (i * 7919) % 997, noop_callback, nullptr);
+        }
+    }
+};
+
+TEST_F(BenchDeferredExec, defer_extend_cancel_with_many_pending_executors) {
+    fill_table();
+
+    uint32_t i = 0;
+    benchmark([&] {
+        deferred_token token = defer_exec_advanced(table, table_count, 1 + (i * 7919) % 997, noop_callback, nullptr);
+        extend_deferred_exec_advanced(table, table_count, token, 1 + (i * 104729) % 997);
+        cancel_deferred_exec_advanced(table, table_count, token);
+        i++;
+    });
+}
+
+TEST_F(BenchDeferredExec, next_deadline_with_many_pending_executors) {
+    fill_table();
+
+    uint32_t deadline;
+    benchmark([&] { deferred_exec_advanced_next_deadline(table, table_count, &deadline); });
+}
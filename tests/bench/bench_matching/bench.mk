@@ -0,0 +1,12 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains benchmarks
+# --------------------------------------------------------------------------------
+
+COMBO_ENABLE = yes
+KEY_OVERRIDE_ENABLE = yes
+
+# The ko_make_* initializers are C only
+SRC += tests/bench/bench_matching/key_overrides.c
@@ -0,0 +1,205 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_benchmark.hpp"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "host.h"
+
+// Each key combined with the next one, from A to 7
+const uint16_t PROGMEM combo_a_b[] = {KC_A, KC_B, COMBO_END};
+const uint16_t PROGMEM combo_b_c[] = {KC_B, KC_C, COMBO_END};
+const uint16_t PROGMEM combo_c_d[] = {KC_C, KC_D, COMBO_END};
+const uint16_t PROGMEM combo_d_e[] = {KC_D, KC_E, COMBO_END};
+const uint16_t PROGMEM combo_e_f[] = {KC_E, KC_F, COMBO_END};
+const uint16_t PROGMEM combo_f_g[] = {KC_F, KC_G, COMBO_END};
+const uint16_t PROGMEM combo_g_h[] = {KC_G, KC_H, COMBO_END};
+const uint16_t PROGMEM combo_h_i[] = {KC_H, KC_I, COMBO_END};
+const uint16_t PROGMEM combo_i_j[] = {KC_I, KC_J, COMBO_END};
+const uint16_t PROGMEM combo_j_k[] = {KC_J, KC_K, COMBO_END};
+const uint16_t PROGMEM combo_k_l[] = {KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM combo_l_m[] = {KC_L, KC_M, COMBO_END};
+const uint16_t PROGMEM combo_m_n[] = {KC_M, KC_N, COMBO_END};
+const uint16_t PROGMEM combo_n_o[] = {KC_N, KC_O, COMBO_END};
+const uint16_t PROGMEM combo_o_p[] = {KC_O, KC_P, COMBO_END};
+const uint16_t PROGMEM combo_p_q[] = {KC_P, KC_Q, COMBO_END};
+const uint16_t PROGMEM combo_q_r[] = {KC_Q, KC_R, COMBO_END};
+const uint16_t PROGMEM combo_r_s[] = {KC_R, KC_S, COMBO_END};
+const uint16_t PROGMEM combo_s_t[] = {KC_S, KC_T, COMBO_END};
+const uint16_t PROGMEM combo_t_u[] = {KC_T, KC_U, COMBO_END};
+const uint16_t PROGMEM combo_u_v[] = {KC_U, KC_V, COMBO_END};
+const uint16_t PROGMEM combo_v_w[] = {KC_V, KC_W, COMBO_END};
+const uint16_t PROGMEM combo_w_x[] = {KC_W, KC_X, COMBO_END};
+const uint16_t PROGMEM combo_x_y[] = {KC_X, KC_Y, COMBO_END};
+const uint16_t PROGMEM combo_y_z[] = {KC_Y, KC_Z, COMBO_END};
+const uint16_t PROGMEM combo_z_1[] = {KC_Z, KC_1, COMBO_END};
+const uint16_t PROGMEM combo_1_2[] = {KC_1, KC_2, COMBO_END};
+const uint16_t PROGMEM combo_2_3[] = {KC_2, KC_3, COMBO_END};
+const uint16_t PROGMEM combo_3_4[] = {KC_3, KC_4, COMBO_END};
+const uint16_t PROGMEM combo_4_5[] = {KC_4, KC_5, COMBO_END};
+const uint16_t PROGMEM combo_5_6[] = {KC_5, KC_6, COMBO_END};
+const uint16_t PROGMEM combo_6_7[] = {KC_6, KC_7, COMBO_END};
+
+// clang-format off
+combo_t key_combos[] = {
+    COMBO(combo_a_b, KC_ENT),
+    COMBO(combo_b_c, KC_ENT),
+    COMBO(combo_c_d, KC_ENT),
+    COMBO(combo_d_e, KC_ENT),
+    COMBO(combo_e_f, KC_ENT),
+    COMBO(combo_f_g, KC_ENT),
+    COMBO(combo_g_h, KC_ENT),
+    COMBO(combo_h_i, KC_ENT),
+    COMBO(combo_i_j, KC_ENT),
+    COMBO(combo_j_k, KC_ENT),
+    COMBO(combo_k_l, KC_ENT),
+    COMBO(combo_l_m, KC_ENT),
+    COMBO(combo_m_n, KC_ENT),
+    COMBO(combo_n_o, KC_ENT),
+    COMBO(combo_o_p, KC_ENT),
+    COMBO(combo_p_q, KC_ENT),
+    COMBO(combo_q_r, KC_ENT),
+    COMBO(combo_r_s, KC_ENT),
+    COMBO(combo_s_t, KC_ENT),
+    COMBO(combo_t_u, KC_ENT),
+    COMBO(combo_u_v, KC_ENT),
+    COMBO(combo_v_w, KC_ENT),
+    COMBO(combo_w_x, KC_ENT),
+    COMBO(combo_x_y, KC_ENT),
+    COMBO(combo_y_z, KC_ENT),
+    COMBO(combo_z_1, KC_ENT),
+    COMBO(combo_1_2, KC_ENT),
+    COMBO(combo_2_3, KC_ENT),
+    COMBO(combo_3_4, KC_ENT),
+    COMBO(combo_4_5, KC_ENT),
+    COMBO(combo_5_6, KC_ENT),
+    COMBO(combo_6_7, KC_ENT),
+};
+// clang-format on
+uint16_t COMBO_LEN = sizeof(key_combos) / sizeof(key_combos[0]);
+}
+
+/* MAKE_KEYEVENT() has its designators out of order for C++ */
+static keyevent_t key_event(uint8_t row, uint8_t col, bool pressed) {
+    return (keyevent_t){.key = {.col = col, .row = row}, .pressed = pressed, .time = (uint16_t)(timer_read() | 1)};
+}
+
+/* The key at index in the keymap, row by row */
+static keyevent_t key_event(uint8_t index, bool pressed) {
+    return key_event(index / MATRIX_COLS, index % MATRIX_COLS, pressed);
+}
+
+class BenchMatching : public TestFixture {
+   public:
+    void SetUp() override {
+        static const uint16_t codes[] = {
+        KC_A,
+        KC_B,
+        KC_C,
+        KC_D,
+        KC_E,
+        KC_F,
+        KC_G,
+        KC_H,
+        KC_I,
+        KC_J,
+        KC_K,
+        KC_L,
+        KC_M,
+        KC_N,
+        KC_O,
+        KC_P,
+        KC_Q,
+        KC_R,
+        KC_S,
+        KC_T,
+        KC_U,
+        KC_V,
+        KC_W,
+        KC_X,
+        KC_Y,
+        KC_Z,
+        KC_1,
+        KC_2,
+        KC_3,
+        KC_4,
+        KC_5,
+        KC_6,
+        KC_7,
+        KC_8,
+        KC_9,
+        KC_0,
+        KC_MINS,
+        KC_EQL,
+        KC_LBRC,
+        KC_RBRC
+        };
+
+        keymap.clear();
+        for (uint8_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+            add_key(KeymapKey(0, i % MATRIX_COLS, i / MATRIX_COLS, codes[i]));
+        }
+
+        // Reports go nowhere, so that only the firmware is measured
+        saved_driver = host_get_driver();
+        host_set_driver(nullptr);
+    }
+
+    void TearDown() override {
+        // Every benchmark releases what it pressed
+        EXPECT_FALSE(has_anykey(keyboard_report));
+        clear_mods();
+        host_set_driver(saved_driver);
+    }
+
+   private:
+    host_driver_t *saved_driver;
+};
+
+/* A key which is in no combo and has no override */
+TEST_F(BenchMatching, plain_key) {
+    benchmark([] {
+        action_exec(key_event(39, true));
+        action_exec(key_event(39, false));
+    });
+}
+
+/* A key which is part of two combos, tapped on its own */
+TEST_F(BenchMatching, combo_key_alone) {
+    benchmark([] {
+        action_exec(key_event(10, true));
+        action_exec(key_event(10, false));
+    });
+}
+
+TEST_F(BenchMatching, combo_chord) {
+    benchmark([] {
+        action_exec(key_event(10, true));
+        action_exec(key_event(11, true));
+        action_exec(key_event(10, false));
+        action_exec(key_event(11, false));
+    });
+}
+
+/* Shift held on a key which is in no combo and has no override */
+TEST_F(BenchMatching, key_override_no_match) {
+    register_mods(MOD_BIT(KC_LSFT));
+    benchmark([] {
+        action_exec(key_event(39, true));
+        action_exec(key_event(39, false));
+    });
+    unregister_mods(MOD_BIT(KC_LSFT));
+}
+
+TEST_F(BenchMatching, key_override_match) {
+    register_mods(MOD_BIT(KC_LSFT));
+    benchmark([] {
+        action_exec(key_event(34, true));
+        action_exec(key_event(34, false));
+    });
+    unregister_mods(MOD_BIT(KC_LSFT));
+}
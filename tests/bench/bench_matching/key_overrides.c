@@ -0,0 +1,76 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// Shift overrides on the keys from U to 9, ctrl overrides on the keys from E to T
+static const key_override_t shift_u = ko_make_basic(MOD_MASK_SHIFT, KC_U, KC_F1);
+static const key_override_t shift_v = ko_make_basic(MOD_MASK_SHIFT, KC_V, KC_F2);
+static const key_override_t shift_w = ko_make_basic(MOD_MASK_SHIFT, KC_W, KC_F3);
+static const key_override_t shift_x = ko_make_basic(MOD_MASK_SHIFT, KC_X, KC_F4);
+static const key_override_t shift_y = ko_make_basic(MOD_MASK_SHIFT, KC_Y, KC_F5);
+static const key_override_t shift_z = ko_make_basic(MOD_MASK_SHIFT, KC_Z, KC_F6);
+static const key_override_t shift_1 = ko_make_basic(MOD_MASK_SHIFT, KC_1, KC_F7);
+static const key_override_t shift_2 = ko_make_basic(MOD_MASK_SHIFT, KC_2, KC_F8);
+static const key_override_t shift_3 = ko_make_basic(MOD_MASK_SHIFT, KC_3, KC_F9);
+static const key_override_t shift_4 = ko_make_basic(MOD_MASK_SHIFT, KC_4, KC_F10);
+static const key_override_t shift_5 = ko_make_basic(MOD_MASK_SHIFT, KC_5, KC_F11);
+static const key_override_t shift_6 = ko_make_basic(MOD_MASK_SHIFT, KC_6, KC_F12);
+static const key_override_t shift_7 = ko_make_basic(MOD_MASK_SHIFT, KC_7, KC_F13);
+static const key_override_t shift_8 = ko_make_basic(MOD_MASK_SHIFT, KC_8, KC_F14);
+static const key_override_t shift_9 = ko_make_basic(MOD_MASK_SHIFT, KC_9, KC_F15);
+static const key_override_t shift_0 = ko_make_basic(MOD_MASK_SHIFT, KC_0, KC_F16);
+static const key_override_t ctrl_e  = ko_make_basic(MOD_MASK_CTRL, KC_E, KC_F5);
+static const key_override_t ctrl_f  = ko_make_basic(MOD_MASK_CTRL, KC_F, KC_F6);
+static const key_override_t ctrl_g  = ko_make_basic(MOD_MASK_CTRL, KC_G, KC_F7);
+static const key_override_t ctrl_h  = ko_make_basic(MOD_MASK_CTRL, KC_H, KC_F8);
+static const key_override_t ctrl_i  = ko_make_basic(MOD_MASK_CTRL, KC_I, KC_F9);
+static const key_override_t ctrl_j  = ko_make_basic(MOD_MASK_CTRL, KC_J, KC_F10);
+static const key_override_t ctrl_k  = ko_make_basic(MOD_MASK_CTRL, KC_K, KC_F11);
+static const key_override_t ctrl_l  = ko_make_basic(MOD_MASK_CTRL, KC_L, KC_F12);
+static const key_override_t ctrl_m  = ko_make_basic(MOD_MASK_CTRL, KC_M, KC_F13);
+static const key_override_t ctrl_n  = ko_make_basic(MOD_MASK_CTRL, KC_N, KC_F14);
+static const key_override_t ctrl_o  = ko_make_basic(MOD_MASK_CTRL, KC_O, KC_F15);
+static const key_override_t ctrl_p  = ko_make_basic(MOD_MASK_CTRL, KC_P, KC_F16);
+static const key_override_t ctrl_q  = ko_make_basic(MOD_MASK_CTRL, KC_Q, KC_F17);
+static const key_override_t ctrl_r  = ko_make_basic(MOD_MASK_CTRL, KC_R, KC_F18);
+static const key_override_t ctrl_s  = ko_make_basic(MOD_MASK_CTRL, KC_S, KC_F19);
+static const key_override_t ctrl_t  = ko_make_basic(MOD_MASK_CTRL, KC_T, KC_F20);
+
+// clang-format off
+const key_override_t **key_overrides = (const key_override_t *[]){
+    &shift_u,
+    &shift_v,
+    &shift_w,
+    &shift_x,
+    &shift_y,
+    &shift_z,
+    &shift_1,
+    &shift_2,
+    &shift_3,
+    &shift_4,
+    &shift_5,
+    &shift_6,
+    &shift_7,
+    &shift_8,
+    &shift_9,
+    &shift_0,
+    &ctrl_e,
+    &ctrl_f,
+    &ctrl_g,
+    &ctrl_h,
+    &ctrl_i,
+    &ctrl_j,
+    &ctrl_k,
+    &ctrl_l,
+    &ctrl_m,
+    &ctrl_n,
+    &ctrl_o,
+    &ctrl_p,
+    &ctrl_q,
+    &ctrl_r,
+    &ctrl_s,
+    &ctrl_t,
+    NULL
+};
+// clang-format on
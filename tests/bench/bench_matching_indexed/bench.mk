@@ -0,0 +1,13 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains benchmarks
+# --------------------------------------------------------------------------------
+
+COMBO_ENABLE = yes
+KEY_OVERRIDE_ENABLE = yes
+
+# Same benchmarks as bench_matching, with the combo and key override indexes
+SRC += tests/bench/bench_matching/bench_matching.cpp \
+	tests/bench/bench_matching/key_overrides.c
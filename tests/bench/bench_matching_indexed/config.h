@@ -0,0 +1,9 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define COMBO_KEY_INDEX_LENGTH 64
+#define KEY_OVERRIDE_INDEX_LENGTH 32
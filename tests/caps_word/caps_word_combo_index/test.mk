@@ -0,0 +1,9 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+CAPS_WORD_ENABLE = yes
+COMBO_ENABLE = yes
+AUTO_SHIFT_ENABLE = yes
+
+# Same scenarios as caps_word_combo, with the combo key index enabled
+SRC += tests/caps_word/caps_word_combo/test_caps_word_combo.cpp
@@ -0,0 +1,242 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+namespace {
+
+struct CallRecord {
+    uint32_t trigger_time;
+    uintptr_t id;
+};
+
+std::vector<CallRecord> calls;
+uint32_t                repeat_delay = 0;
+
+uint32_t record_callback(uint32_t trigger_time, void *cb_arg) {
+    calls.push_back({trigger_time, reinterpret_cast<uintptr_t>(cb_arg)});
+    return repeat_delay;
+}
+
+constexpr size_t    kLargeTableCount = 250;
+deferred_executor_t large_table[kLargeTableCount];
+uint32_t            large_table_last_exec;
+
+deferred_token cancel_target = INVALID_DEFERRED_TOKEN;
+
+uint32_t cancelling_callback(uint32_t trigger_time, void *cb_arg) {
+    calls.push_back({trigger_time, reinterpret_cast<uintptr_t>(cb_arg)});
+    EXPECT_TRUE(cancel_deferred_exec_advanced(large_table, kLargeTableCount, cancel_target));
+    return 0;
+}
+
+} // namespace
+
+class DeferredExec : public ::testing::Test {
+   protected:
+    uint32_t start_time;
+
+    void SetUp() override {
+        // The basic executor table throttles against its last execution, so time must keep moving forwards
+        advance_time(10000);
+        start_time = timer_read32();
+        calls.clear();
+        repeat_delay = 0;
+        std::fill(std::begin(large_table), std::end(large_table), deferred_executor_t{});
+        large_table_last_exec = start_time;
+    }
+
+    /* Runs the basic executor task once per millisecond for the given duration */
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+
+    void run_large_table_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            deferred_exec_advanced_task(large_table, kLargeTableCount, &large_table_last_exec);
+        }
+    }
+};
+
+TEST_F(DeferredExec, executes_once_after_delay) {
+    deferred_token token = defer_exec(10, record_callback, nullptr);
+    EXPECT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    run_for(9);
+    EXPECT_TRUE(calls.empty());
+
+    run_for(1);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].trigger_time, start_time + 10);
+
+    run_for(100);
+    EXPECT_EQ(calls.size(), 1);
+    EXPECT_FALSE(cancel_deferred_exec(token));
+}
+
+TEST_F(DeferredExec, repeats_relative_to_trigger_time) {
+    repeat_delay         = 20;
+    deferred_token token = defer_exec(10, record_callback, nullptr);
+
+    run_for(55);
+    ASSERT_EQ(calls.size(), 3);
+    EXPECT_EQ(calls[0].trigger_time, start_time + 10);
+    EXPECT_EQ(calls[1].trigger_time, start_time + 30);
+    EXPECT_EQ(calls[2].trigger_time, start_time + 50);
+
+    EXPECT_TRUE(cancel_deferred_exec(token));
+    run_for(100);
+    EXPECT_EQ(calls.size(), 3);
+}
+
+TEST_F(DeferredExec, cancel_prevents_execution) {
+    deferred_token token = defer_exec(10, record_callback, nullptr);
+
+    EXPECT_TRUE(cancel_deferred_exec(token));
+    EXPECT_FALSE(cancel_deferred_exec(token));
+    run_for(100);
+    EXPECT_TRUE(calls.empty());
+}
+
+TEST_F(DeferredExec, extend_delays_execution) {
+    deferred_token token = defer_exec(10, record_callback, nullptr);
+
+    run_for(5);
+    EXPECT_TRUE(extend_deferred_exec(token, 10));
+    run_for(9);
+    EXPECT_TRUE(calls.empty());
+    run_for(1);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].trigger_time, start_time + 15);
+}
+
+TEST_F(DeferredExec, stale_token_does_not_affect_reused_slot) {
+    deferred_token first = defer_exec(10, record_callback, reinterpret_cast<void *>(1));
+    EXPECT_TRUE(cancel_deferred_exec(first));
+
+    deferred_token second = defer_exec(10, record_callback, reinterpret_cast<void *>(2));
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(cancel_deferred_exec(first));
+    EXPECT_FALSE(extend_deferred_exec(first, 100));
+
+    run_for(10);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].id, 2);
+}
+
+TEST_F(DeferredExec, stale_tokens_do_not_cancel_new_executor) {
+    std::vector<deferred_token> stale;
+
+    // Executors which ran and executors which were cancelled both leave their tokens behind
+    for (uintptr_t i = 0; i < 7; ++i) {
+        stale.push_back(defer_exec(1, record_callback, reinterpret_cast<void *>(i)));
+        run_for(1);
+        stale.push_back(defer_exec(10, record_callback, reinterpret_cast<void *>(i)));
+        EXPECT_TRUE(cancel_deferred_exec(stale.back()));
+    }
+    calls.clear();
+
+    deferred_token current = defer_exec(10, record_callback, reinterpret_cast<void *>(100));
+    EXPECT_NE(current, INVALID_DEFERRED_TOKEN);
+    for (auto token : stale) {
+        EXPECT_FALSE(cancel_deferred_exec(token));
+        EXPECT_FALSE(extend_deferred_exec(token, 100));
+    }
+
+    run_for(10);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].id, 100);
+    EXPECT_EQ(calls[0].trigger_time, start_time + 7 + 10);
+}
+
+TEST_F(DeferredExec, rejects_invalid_requests) {
+    EXPECT_EQ(defer_exec(0, record_callback, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec(10, nullptr, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_FALSE(cancel_deferred_exec(INVALID_DEFERRED_TOKEN));
+    EXPECT_FALSE(extend_deferred_exec(INVALID_DEFERRED_TOKEN, 10));
+}
+
+TEST_F(DeferredExec, next_deadline_tracks_earliest_executor) {
+    deferred_executor_t table[4] = {};
+    uint32_t            deadline = 0;
+
+    EXPECT_FALSE(deferred_exec_advanced_next_deadline(table, 4, &deadline));
+
+    deferred_token late  = defer_exec_advanced(table, 4, 50, record_callback, nullptr);
+    deferred_token early = defer_exec_advanced(table, 4, 20, record_callback, nullptr);
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, 4, &deadline));
+    EXPECT_EQ(deadline, start_time + 20);
+
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 4, early));
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, 4, &deadline));
+    EXPECT_EQ(deadline, start_time + 50);
+
+    EXPECT_TRUE(extend_deferred_exec_advanced(table, 4, late, 5));
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, 4, &deadline));
+    EXPECT_EQ(deadline, start_time + 5);
+
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 4, late));
+    EXPECT_FALSE(deferred_exec_advanced_next_deadline(table, 4, &deadline));
+}
+
+TEST_F(DeferredExec, full_table_rejects_new_executors) {
+    deferred_executor_t table[3] = {};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_NE(defer_exec_advanced(table, 3, 10, record_callback, nullptr), INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer_exec_advanced(table, 3, 10, record_callback, nullptr), INVALID_DEFERRED_TOKEN);
+}
+
+TEST_F(DeferredExec, many_pending_executors_run_in_trigger_order) {
+    std::vector<deferred_token> tokens;
+
+    // Pseudo-random but deterministic delays, with plenty of duplicates
+    for (uintptr_t i = 0; i < kLargeTableCount; ++i) {
+        uint32_t delay = 1 + (i * 7919) % 97;
+        tokens.push_back(defer_exec_advanced(large_table, kLargeTableCount, delay, record_callback, reinterpret_cast<void *>(i)));
+        EXPECT_NE(tokens.back(), INVALID_DEFERRED_TOKEN);
+    }
+
+    // Cancel every third executor
+    for (size_t i = 0; i < tokens.size(); i += 3) {
+        EXPECT_TRUE(cancel_deferred_exec_advanced(large_table, kLargeTableCount, tokens[i]));
+    }
+
+    run_large_table_for(100);
+
+    EXPECT_EQ(calls.size(), kLargeTableCount - (kLargeTableCount + 2) / 3);
+    for (size_t i = 1; i < calls.size(); ++i) {
+        EXPECT_LE(calls[i - 1].trigger_time, calls[i].trigger_time);
+    }
+    for (auto &call : calls) {
+        EXPECT_NE(call.id % 3, 0);
+        EXPECT_EQ(call.trigger_time, start_time + 1 + (call.id * 7919) % 97);
+    }
+}
+
+TEST_F(DeferredExec, callback_can_cancel_other_executor) {
+    defer_exec_advanced(large_table, kLargeTableCount, 10, cancelling_callback, reinterpret_cast<void *>(1));
+    cancel_target = defer_exec_advanced(large_table, kLargeTableCount, 10, record_callback, reinterpret_cast<void *>(2));
+    defer_exec_advanced(large_table, kLargeTableCount, 11, record_callback, reinterpret_cast<void *>(3));
+
+    run_large_table_for(20);
+
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[0].id, 1);
+    EXPECT_EQ(calls[1].id, 3);
+}
@@ -0,0 +1,10 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// Fewer entries than there are overrides
+#define KEY_OVERRIDE_INDEX_LENGTH 4
+#define KEY_OVERRIDE_REPEAT_DELAY 500
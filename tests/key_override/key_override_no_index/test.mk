@@ -0,0 +1,8 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+KEY_OVERRIDE_ENABLE = yes
+
+# Same scenarios as key_override, checking every override in turn without the trigger index
+SRC += tests/key_override/key_overrides.c
+SRC += tests/key_override/test_key_override.cpp
@@ -0,0 +1,25 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+static const key_override_t shift_bspc_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+static const key_override_t ctrl_a_b_override   = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_B);
+static const key_override_t alt_g_override      = ko_make_basic(MOD_MASK_ALT, KC_G, KC_Y);
+static const key_override_t ctrl_e_override     = ko_make_with_layers_and_negmods(MOD_MASK_CTRL, KC_E, KC_F, ~0, MOD_MASK_SHIFT);
+// Shadowed by ctrl_a_b_override, which comes first
+static const key_override_t ctrl_a_c_override = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_C);
+// Only needs alt, but comes after alt_g_override
+static const key_override_t alt_override = ko_make_basic(MOD_MASK_ALT, KC_NO, KC_X);
+
+// clang-format off
+const key_override_t **key_overrides = (const key_override_t *[]){
+    &shift_bspc_override,
+    &ctrl_a_b_override,
+    &alt_g_override,
+    &ctrl_e_override,
+    &ctrl_a_c_override,
+    &alt_override,
+    NULL
+};
+// clang-format on
@@ -0,0 +1,7 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+KEY_OVERRIDE_ENABLE = yes
+
+# The ko_make_* initializers are C only
+SRC += tests/key_override/key_overrides.c
@@ -0,0 +1,168 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class KeyOverride : public TestFixture {};
+
+TEST_F(KeyOverride, trigger_with_mods_sends_replacement) {
+    TestDriver driver;
+    InSequence s;
+    auto       shift_key = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       bspc_key  = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({shift_key, bspc_key});
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    shift_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_DEL));
+    bspc_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    bspc_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    shift_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyOverride, trigger_without_mods_is_sent_unchanged) {
+    TestDriver driver;
+    InSequence s;
+    auto       bspc_key = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({bspc_key});
+
+    EXPECT_REPORT(driver, (KC_BSPC));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(bspc_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyOverride, first_override_for_a_trigger_wins) {
+    TestDriver driver;
+    InSequence s;
+    auto       ctrl_key = KeymapKey(0, 0, 0, KC_LCTL);
+    auto       a_key    = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({ctrl_key, a_key});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    ctrl_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    a_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    a_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    ctrl_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyOverride, negative_mods_prevent_activation) {
+    TestDriver driver;
+    InSequence s;
+    auto       ctrl_key  = KeymapKey(0, 0, 0, KC_LCTL);
+    auto       shift_key = KeymapKey(0, 1, 0, KC_LSFT);
+    auto       e_key     = KeymapKey(0, 2, 0, KC_E);
+
+    set_keymap({ctrl_key, shift_key, e_key});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    ctrl_key.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_LCTL, KC_LSFT));
+    shift_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LCTL, KC_LSFT, KC_E));
+    EXPECT_REPORT(driver, (KC_LCTL, KC_LSFT));
+    tap_key(e_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    ctrl_key.release();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    shift_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyOverride, other_keys_with_mods_are_sent_unchanged) {
+    TestDriver driver;
+    InSequence s;
+    auto       ctrl_key = KeymapKey(0, 0, 0, KC_LCTL);
+    auto       z_key    = KeymapKey(0, 1, 0, KC_Z);
+
+    set_keymap({ctrl_key, z_key});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    ctrl_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LCTL, KC_Z));
+    EXPECT_REPORT(driver, (KC_LCTL));
+    tap_key(z_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    ctrl_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyOverride, mod_down_activates_the_first_matching_override) {
+    TestDriver driver;
+    InSequence s;
+    auto       alt_key = KeymapKey(0, 0, 0, KC_LALT);
+    auto       g_key   = KeymapKey(0, 1, 0, KC_G);
+
+    set_keymap({alt_key, g_key});
+
+    EXPECT_REPORT(driver, (KC_G));
+    g_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Both overrides match once alt goes down, the one triggered by the held key is listed first */
+    EXPECT_EMPTY_REPORT(driver).Times(testing::AnyNumber());
+    EXPECT_REPORT(driver, (KC_Y));
+    alt_key.press();
+    run_one_scan_loop();
+    idle_for(KEY_OVERRIDE_REPEAT_DELAY);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    g_key.release();
+    run_one_scan_loop();
+    alt_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
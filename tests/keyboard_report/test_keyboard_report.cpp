@@ -0,0 +1,204 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <random>
+#include "gtest/gtest.h"
+#include "keycode.h"
+
+extern "C" {
+#include "action_util.h"
+#include "host.h"
+#include "keyboard_report_reference.h"
+#include "keycode_config.h"
+#include "report.h"
+}
+
+static report_keyboard_t make_report(uint8_t mods, std::initializer_list<uint8_t> keys) {
+    report_keyboard_t report = {};
+    report.mods              = mods;
+    for (uint8_t key : keys) {
+        add_key_to_report(&report, key);
+    }
+    return report;
+}
+
+TEST(KeyboardReport, release_can_be_replaced_by_a_press) {
+    report_keyboard_t previous = make_report(0, {KC_A});
+    report_keyboard_t queued   = make_report(0, {});
+    report_keyboard_t next     = make_report(0, {KC_B});
+
+    EXPECT_TRUE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, press_can_be_replaced_by_a_release_of_another_key) {
+    report_keyboard_t previous = make_report(0, {KC_B});
+    report_keyboard_t queued   = make_report(0, {KC_B, KC_A});
+    report_keyboard_t next     = make_report(0, {KC_A});
+
+    EXPECT_TRUE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, press_cannot_be_replaced_by_another_press) {
+    report_keyboard_t previous = make_report(0, {});
+    report_keyboard_t queued   = make_report(0, {KC_A});
+    report_keyboard_t next     = make_report(0, {KC_A, KC_B});
+
+    // The host could see B before A
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, press_cannot_be_replaced_by_its_release) {
+    report_keyboard_t previous = make_report(0, {});
+    report_keyboard_t queued   = make_report(0, {KC_A});
+    report_keyboard_t next     = make_report(0, {});
+
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, release_cannot_be_replaced_by_a_press_of_the_same_key) {
+    report_keyboard_t previous = make_report(0, {KC_A});
+    report_keyboard_t queued   = make_report(0, {});
+    report_keyboard_t next     = make_report(0, {KC_A});
+
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, modifier_can_be_replaced_by_a_press) {
+    report_keyboard_t previous = make_report(0, {});
+    report_keyboard_t queued   = make_report(MOD_BIT(KC_LSFT), {});
+    report_keyboard_t next     = make_report(MOD_BIT(KC_LSFT), {KC_A});
+
+    // Modifiers are applied first, so A is still shifted
+    EXPECT_TRUE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, press_cannot_be_replaced_by_a_modifier_change) {
+    report_keyboard_t previous = make_report(MOD_BIT(KC_LSFT), {});
+    report_keyboard_t queued   = make_report(MOD_BIT(KC_LSFT), {KC_A});
+    report_keyboard_t next     = make_report(0, {KC_A});
+
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, modifier_cannot_be_replaced_by_its_release) {
+    report_keyboard_t previous = make_report(0, {});
+    report_keyboard_t queued   = make_report(MOD_BIT(KC_LCTL), {});
+    report_keyboard_t next     = make_report(0, {});
+
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+}
+
+TEST(KeyboardReport, nkro_press_cannot_be_replaced_by_another_press) {
+    keymap_config.nkro       = true;
+    report_keyboard_t previous = make_report(0, {});
+    report_keyboard_t queued   = make_report(0, {KC_A});
+    report_keyboard_t next     = make_report(0, {KC_A, KC_F12});
+    report_keyboard_t released = make_report(0, {KC_F12});
+
+    EXPECT_FALSE(can_replace_keyboard_report(&previous, &queued, &next));
+    EXPECT_TRUE(can_replace_keyboard_report(&queued, &next, &released));
+    keymap_config.nkro = false;
+}
+
+/* Applies the same random changes to reports through report.c and through the byte by byte reference, which have to
+ * agree on everything. Runs for the shared keyboard_report, which has the NKRO summary, and for a report of its own. */
+class KeyboardReportReference : public ::testing::TestWithParam<bool> {
+   protected:
+    void SetUp() override {
+        keymap_config.nkro = GetParam();
+        clear_keys_from_report(keyboard_report);
+    }
+
+    void TearDown() override {
+        clear_keys_from_report(keyboard_report);
+        keymap_config.nkro = false;
+    }
+
+    static void expect_same(report_keyboard_t *report, report_keyboard_t *reference) {
+        ASSERT_EQ(memcmp(report, reference, sizeof(report_keyboard_t)), 0);
+        EXPECT_EQ((bool)has_anykey(report), (bool)reference_has_anykey(reference));
+        EXPECT_EQ(get_first_key(report), reference_get_first_key(reference));
+        for (int key = 0; key < 256; key++) {
+            ASSERT_EQ(is_key_pressed(report, key), reference_is_key_pressed(reference, key)) << "key " << key;
+        }
+    }
+
+    static void play_random_changes(report_keyboard_t *report) {
+        std::mt19937      random(42);
+        report_keyboard_t reference = *report;
+
+        for (int i = 0; i < 2000; i++) {
+            // Mostly letters and numbers, so that keys pile up, sometimes anything up to the end of the bitmap
+            const uint8_t key = random() % 8 ? KC_A + random() % 40 : random() % 256;
+            switch (random() % 16) {
+                case 0:
+                    clear_keys_from_report(report);
+                    reference_clear_keys_from_report(&reference);
+                    break;
+                case 1 ... 7:
+                    del_key_from_report(report, key);
+                    reference_del_key_from_report(&reference, key);
+                    break;
+                default:
+                    add_key_to_report(report, key);
+                    reference_add_key_to_report(&reference, key);
+                    break;
+            }
+            expect_same(report, &reference);
+            if (HasFatalFailure()) {
+                return;
+            }
+        }
+    }
+};
+
+TEST_P(KeyboardReportReference, shared_report_matches) {
+    play_random_changes(keyboard_report);
+}
+
+TEST_P(KeyboardReportReference, own_report_matches) {
+    report_keyboard_t report = {};
+    play_random_changes(&report);
+}
+
+TEST_P(KeyboardReportReference, empty_report_has_no_keys) {
+    report_keyboard_t report = {};
+
+    EXPECT_FALSE(has_anykey(&report));
+    EXPECT_EQ(get_first_key(&report), KC_NO);
+    EXPECT_FALSE(has_anykey(keyboard_report));
+    EXPECT_EQ(get_first_key(keyboard_report), KC_NO);
+}
+
+TEST_P(KeyboardReportReference, last_key_of_the_nkro_bitmap) {
+    const uint8_t key = GetParam() ? KEYBOARD_REPORT_BITS * 8 - 1 : KC_A;
+
+    add_key_to_report(keyboard_report, key);
+    EXPECT_TRUE(has_anykey(keyboard_report));
+    EXPECT_EQ(get_first_key(keyboard_report), key);
+    EXPECT_TRUE(is_key_pressed(keyboard_report, key));
+
+    del_key_from_report(keyboard_report, key);
+    EXPECT_FALSE(has_anykey(keyboard_report));
+}
+
+INSTANTIATE_TEST_CASE_P(Protocol, KeyboardReportReference, ::testing::Values(false, true), [](const ::testing::TestParamInfo<bool> &info) { return info.param ? "nkro" : "6kro"; });
+
+TEST(KeyboardReport, switching_to_nkro_rescans_the_shared_report) {
+    // The summary is built while the shared report is empty
+    keymap_config.nkro = true;
+    clear_keys_from_report(keyboard_report);
+    EXPECT_FALSE(has_anykey(keyboard_report));
+
+    // and has to be dropped once keys are added without NKRO
+    keymap_config.nkro = false;
+    add_key_to_report(keyboard_report, KC_A);
+    keymap_config.nkro = true;
+    EXPECT_EQ((bool)has_anykey(keyboard_report), (bool)reference_has_anykey(keyboard_report));
+    EXPECT_EQ(get_first_key(keyboard_report), reference_get_first_key(keyboard_report));
+
+    clear_keys_from_report(keyboard_report);
+    keymap_config.nkro = false;
+    clear_keys_from_report(keyboard_report);
+}
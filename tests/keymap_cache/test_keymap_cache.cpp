@@ -0,0 +1,158 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "keymap_cache.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class KeymapCache : public TestFixture {
+   public:
+    static bool cached_layer(uint8_t row, uint8_t col, uint8_t *layer) {
+        return keymap_cache_get_layer((keypos_t){.col = col, .row = row}, layer);
+    }
+
+    /* The cache resolves every key, so the remaining positions are mapped to KC_NO on the base layer and KC_TRNS above */
+    void fill_keymap(uint8_t layer_count) {
+        for (uint8_t layer = 0; layer < layer_count; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    if (!find_key(layer, (keypos_t){.col = col, .row = row})) {
+                        add_key(KeymapKey(layer, col, row, layer == 0 ? KC_NO : KC_TRNS));
+                    }
+                }
+            }
+        }
+    }
+
+    void rebuild() {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            run_one_scan_loop();
+        }
+    }
+};
+
+TEST_F(KeymapCache, cache_is_rebuilt_one_row_per_scan) {
+    TestDriver driver;
+    uint8_t    layer;
+
+    set_keymap({KeymapKey(0, 0, 0, KC_A), KeymapKey(0, 0, 3, KC_B), KeymapKey(1, 0, 3, KC_C), KeymapKey(1, 0, 0, KC_TRNS)});
+    fill_keymap(2);
+    rebuild();
+    ASSERT_TRUE(cached_layer(0, 0, &layer));
+    EXPECT_EQ(layer, 0);
+
+    layer_on(1);
+    EXPECT_FALSE(cached_layer(0, 0, &layer));
+    EXPECT_FALSE(cached_layer(3, 0, &layer));
+
+    run_one_scan_loop();
+    ASSERT_TRUE(cached_layer(0, 0, &layer));
+    EXPECT_EQ(layer, 0);
+    EXPECT_FALSE(cached_layer(3, 0, &layer));
+
+    for (uint8_t row = 1; row < MATRIX_ROWS; row++) {
+        run_one_scan_loop();
+    }
+    ASSERT_TRUE(cached_layer(3, 0, &layer));
+    EXPECT_EQ(layer, 1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){.col = 0, .row = 3}), 1);
+}
+
+TEST_F(KeymapCache, default_layer_changes_rebuild_the_cache) {
+    TestDriver driver;
+    uint8_t    layer;
+
+    set_keymap({KeymapKey(0, 1, 1, KC_A), KeymapKey(2, 1, 1, KC_B)});
+    fill_keymap(3);
+    rebuild();
+    ASSERT_TRUE(cached_layer(1, 1, &layer));
+    EXPECT_EQ(layer, 0);
+
+    default_layer_set(1 << 2);
+    EXPECT_FALSE(cached_layer(1, 1, &layer));
+    rebuild();
+    ASSERT_TRUE(cached_layer(1, 1, &layer));
+    EXPECT_EQ(layer, 2);
+
+    default_layer_set(1 << 0);
+}
+
+TEST_F(KeymapCache, keymap_changes_invalidate_the_cache) {
+    TestDriver driver;
+    uint8_t    layer;
+
+    set_keymap({KeymapKey(0, 2, 2, KC_A)});
+    fill_keymap(1);
+    rebuild();
+    ASSERT_TRUE(cached_layer(2, 2, &layer));
+
+    add_key(KeymapKey(1, 3, 2, KC_B));
+    EXPECT_FALSE(cached_layer(2, 2, &layer));
+}
+
+TEST_F(KeymapCache, keys_resolve_the_same_while_the_cache_is_rebuilt) {
+    TestDriver driver;
+    InSequence s;
+    auto       layer_key       = KeymapKey(0, 0, 0, MO(1));
+    auto       regular_key     = KeymapKey(0, 1, 3, KC_A);
+    auto       transparent_key = KeymapKey(1, 1, 3, KC_TRNS);
+    auto       base_key        = KeymapKey(0, 2, 3, KC_B);
+    auto       shadowing_key   = KeymapKey(1, 2, 3, KC_C);
+
+    set_keymap({layer_key, regular_key, transparent_key, base_key, shadowing_key});
+    fill_keymap(2);
+    rebuild();
+
+    /* Press the layer key, then a key on the last row straight away, before its row is rebuilt */
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    shadowing_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    shadowing_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Once rebuilt, transparent keys fall through to the layer below */
+    rebuild();
+    EXPECT_REPORT(driver, (KC_A));
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Releasing the layer key brings back the base layer */
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    base_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    base_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,11 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+KEYSTROKE_TRACE_ENABLE = yes
+
+# Lets idle_for() skip the scans where nothing is due
+TEST_VIRTUAL_CLOCK = yes
@@ -0,0 +1,214 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_trace_replay.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class KeystrokeTraceTest : public TestFixture {
+   public:
+    void SetUp() override {
+        keystroke_trace_clear();
+        keystroke_trace_start();
+    }
+
+    static void expect_key_event(uint16_t index, uint16_t delta, const KeymapKey &key, bool pressed) {
+        keystroke_trace_event_t event;
+        ASSERT_TRUE(keystroke_trace_get(index, &event));
+        EXPECT_EQ(event.delta, delta);
+        EXPECT_EQ(event.type, KEYSTROKE_TRACE_KEY);
+        EXPECT_EQ(event.key.row, key.position.row);
+        EXPECT_EQ(event.key.col, key.position.col);
+        EXPECT_EQ(event.key.pressed, pressed);
+    }
+};
+
+TEST_F(KeystrokeTraceTest, records_key_changes_with_their_timing) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 1, 2, KC_A);
+    auto       key_b = KeymapKey(0, 3, 1, KC_B);
+
+    set_keymap({key_a, key_b});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+
+    idle_for(5);
+    tap_key(key_a, 20);
+    idle_for(100);
+    tap_key(key_b);
+
+    EXPECT_EQ(keystroke_trace_count(), 4);
+    expect_key_event(0, 5, key_a, true);
+    expect_key_event(1, 20, key_a, false);
+    expect_key_event(2, 101, key_b, true);
+    expect_key_event(3, 1, key_b, false);
+    EXPECT_FALSE(keystroke_trace_get(4, nullptr));
+}
+
+TEST_F(KeystrokeTraceTest, oldest_events_are_dropped_when_full) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(20);
+
+    for (int i = 0; i < 5; i++) {
+        tap_key(key_a);
+    }
+    for (int i = 0; i < 5; i++) {
+        tap_key(key_b);
+    }
+
+    EXPECT_EQ(keystroke_trace_count(), 16);
+    EXPECT_EQ(keystroke_trace_dropped(), 4);
+    expect_key_event(0, 1, key_a, true);
+    expect_key_event(5, 1, key_a, false);
+    expect_key_event(6, 1, key_b, true);
+    expect_key_event(15, 1, key_b, false);
+}
+
+TEST_F(KeystrokeTraceTest, nothing_is_recorded_while_stopped) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+
+    keystroke_trace_stop();
+    tap_key(key);
+    EXPECT_EQ(keystroke_trace_count(), 0);
+
+    idle_for(10);
+    keystroke_trace_start();
+    idle_for(3);
+    tap_key(key);
+    EXPECT_EQ(keystroke_trace_count(), 2);
+    expect_key_event(0, 3, key, true);
+}
+
+TEST_F(KeystrokeTraceTest, trace_is_read_over_raw_hid) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 2, 3, KC_A);
+    uint8_t    data[32];
+
+    set_keymap({key});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(8);
+
+    for (int i = 0; i < 4; i++) {
+        tap_key(key);
+    }
+
+    memset(data, 0, sizeof(data));
+    data[0] = KEYSTROKE_TRACE_RAW_HID_ID;
+    data[1] = KEYSTROKE_TRACE_CMD_STOP;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_FALSE(keystroke_trace_is_recording());
+
+    data[1] = KEYSTROKE_TRACE_CMD_INFO;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[2] | data[3] << 8, 8);
+    EXPECT_EQ(data[4] | data[5] << 8, 16);
+    EXPECT_EQ(data[6], 0);
+    EXPECT_EQ(data[10], false);
+    EXPECT_EQ(data[11], sizeof(keystroke_trace_event_t));
+
+    /* Up to three events fit in a 32 byte reply */
+    data[1] = KEYSTROKE_TRACE_CMD_READ;
+    data[2] = 6;
+    data[3] = 0;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[4], 2);
+    keystroke_trace_event_t expected;
+    ASSERT_TRUE(keystroke_trace_get(6, &expected));
+    EXPECT_EQ(memcmp(&data[5], &expected, sizeof(expected)), 0);
+    EXPECT_EQ(data[5 + 3], 3);
+    EXPECT_EQ(data[5 + 4], 2);
+    EXPECT_EQ(data[5 + 5], true);
+    EXPECT_EQ(data[5 + 8 + 5], false);
+
+    data[2] = 0;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[4], 3);
+
+    data[1] = KEYSTROKE_TRACE_CMD_CLEAR;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(keystroke_trace_count(), 0);
+
+    data[1] = KEYSTROKE_TRACE_CMD_START;
+    ASSERT_TRUE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_TRUE(keystroke_trace_is_recording());
+
+    /* Requests for other features are left alone */
+    data[0] = KEYSTROKE_TRACE_RAW_HID_ID + 1;
+    data[1] = KEYSTROKE_TRACE_CMD_CLEAR;
+    EXPECT_FALSE(keystroke_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], KEYSTROKE_TRACE_CMD_CLEAR);
+}
+
+TEST_F(KeystrokeTraceTest, replayed_trace_sends_the_same_reports) {
+    TestDriver                     driver;
+    auto                           mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto                           key_a       = KeymapKey(0, 1, 0, KC_A);
+    auto                           key_b       = KeymapKey(0, 2, 1, KC_B);
+    std::vector<report_keyboard_t> recorded_reports;
+    std::vector<report_keyboard_t> replayed_reports;
+
+    set_keymap({mod_tap_key, key_a, key_b});
+
+    /* A tapped mod-tap key with a key tapped inside it, then the mod-tap key held while a key is tapped */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([&](report_keyboard_t &report) { recorded_reports.push_back(report); });
+    mod_tap_key.press();
+    run_one_scan_loop();
+    tap_key(key_a, 10);
+    idle_for(30);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    idle_for(50);
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM + 10);
+    tap_key(key_b, 30);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    ASSERT_EQ(recorded_reports.size(), 8);
+
+    /* Write the trace out like a dump from the keyboard and read it back */
+    const KeystrokeTrace trace = recorded_keystroke_trace();
+    const std::string    path  = testing::TempDir() + "keystroke_trace.bin";
+    ASSERT_EQ(trace.size(), 8);
+    save_keystroke_trace(path, trace);
+    const KeystrokeTrace loaded = load_keystroke_trace(path);
+    ASSERT_EQ(loaded.size(), trace.size());
+    std::remove(path.c_str());
+
+    idle_for(TAPPING_TERM);
+    keystroke_trace_clear();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([&](report_keyboard_t &report) { replayed_reports.push_back(report); });
+    const TraceReplayStats stats = replay_keystroke_trace(loaded);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    ASSERT_EQ(replayed_reports.size(), recorded_reports.size());
+    for (size_t i = 0; i < recorded_reports.size(); i++) {
+        EXPECT_EQ(memcmp(&replayed_reports[i], &recorded_reports[i], sizeof(report_keyboard_t)), 0) << "report " << i;
+    }
+
+    /* Replaying records the events again, with the same timing */
+    const KeystrokeTrace rerecorded = recorded_keystroke_trace();
+    ASSERT_EQ(rerecorded.size(), trace.size());
+    EXPECT_EQ(memcmp(rerecorded.data(), trace.data(), trace.size() * sizeof(keystroke_trace_event_t)), 0);
+
+    EXPECT_EQ(stats.events, trace.size());
+    // The virtual clock jumps over the scans where nothing is due, the trace spans more than a tapping term
+    EXPECT_GE(stats.scans, trace.size());
+    EXPECT_LT(stats.scans, TAPPING_TERM);
+    EXPECT_GT(stats.busy.count(), 0);
+    EXPECT_GE(stats.busy, stats.slowest_scan);
+}
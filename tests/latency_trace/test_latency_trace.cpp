@@ -0,0 +1,192 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "latency_trace.h"
+
+enum combo_events { XY_COMBO, COMBO_LENGTH };
+uint16_t COMBO_LEN = COMBO_LENGTH;
+
+const uint16_t xy_combo[] PROGMEM = {KC_X, KC_Y, COMBO_END};
+
+combo_t key_combos[] = {
+    [XY_COMBO] = COMBO(xy_combo, KC_Z),
+};
+}
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTrace : public TestFixture {
+   public:
+    void SetUp() override {
+        latency_trace_reset();
+    }
+};
+
+TEST_F(LatencyTrace, plain_key_is_traced_on_press_and_release) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 1);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->buckets[0], 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 2);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_TOTAL)->count, 0);
+}
+
+TEST_F(LatencyTrace, latencies_are_timed_in_milliseconds_off_the_cycle_counter) {
+    EXPECT_EQ(latency_trace_resolution(), 1000);
+}
+
+TEST_F(LatencyTrace, mod_tap_key_waits_for_release) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM / 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_TOTAL)->count, 0);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* The press is resolved by the release, the release itself is resolved immediately */
+    const latency_histogram_t *processing = latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_PROCESSING);
+    EXPECT_EQ(processing->count, 2);
+    EXPECT_EQ(processing->max, (TAPPING_TERM / 2 + 1) * latency_trace_resolution());
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_REPORT)->max, 0);
+}
+
+TEST_F(LatencyTrace, layer_key_is_not_traced) {
+    TestDriver driver;
+    InSequence s;
+    auto       layer_key   = KeymapKey(0, 0, 0, MO(1));
+    auto       regular_key = KeymapKey(1, 1, 0, KC_A);
+
+    set_keymap({layer_key, regular_key, KeymapKey(0, 1, 0, KC_B), KeymapKey(1, 0, 0, KC_TRNS)});
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Only the regular key reached the host, and it did so immediately */
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 1);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->max, 0);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LatencyTrace, combo_resolves_only_its_own_keys) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_x = KeymapKey(0, 0, 0, KC_X);
+    auto       key_y = KeymapKey(0, 1, 0, KC_Y);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+
+    set_keymap({key_x, key_y, key_c});
+
+    /* All three keys are detected in the same scan, only two of them make up the combo */
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_REPORT(driver, (KC_Z, KC_C));
+    key_x.press();
+    key_y.press();
+    key_c.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_COMBO, LATENCY_STAGE_TOTAL)->count, 2);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 1);
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    key_c.release();
+    run_one_scan_loop();
+    key_x.release();
+    run_one_scan_loop();
+    key_y.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_COMBO, LATENCY_STAGE_TOTAL)->count, 4);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 2);
+}
+
+TEST_F(LatencyTrace, report_completes_only_the_keys_it_carries) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_C);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    /* The held mod-tap key resolves to shift, which goes out with the regular key's report */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_C));
+    mod_tap_key.press();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_TOTAL)->count, 1);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 1);
+
+    /* Releasing the regular key leaves shift in the report, so the mod-tap release is not completed by it */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_PLAIN, LATENCY_STAGE_TOTAL)->count, 2);
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_TOTAL)->count, 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(latency_trace_get_histogram(LATENCY_EVENT_MOD_TAP, LATENCY_STAGE_TOTAL)->count, 2);
+}
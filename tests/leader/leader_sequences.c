@@ -0,0 +1,14 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// Listed out of order, the matcher sorts them
+const leader_sequence_t leader_sequences[LEADER_SEQUENCE_COUNT] PROGMEM = {
+    LEADER_SEQUENCE(KC_Z, KC_D, KC_D, KC_S),
+    LEADER_SEQUENCE(KC_X, KC_F),
+    LEADER_SEQUENCE_ACTION(KC_A, KC_S),
+    LEADER_SEQUENCE(KC_Y, KC_D, KC_D),
+    // Same keys as the sequence above, never matched
+    LEADER_SEQUENCE(KC_W, KC_D, KC_D),
+};
@@ -0,0 +1,10 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+LEADER_ENABLE = yes
+TICKLESS_IDLE_ENABLE = yes
+
+SRC += tests/leader/leader_sequences.c
+
+# Lets idle_for() skip the scans where nothing is due
+TEST_VIRTUAL_CLOCK = yes
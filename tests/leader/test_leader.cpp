@@ -0,0 +1,161 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+#include <vector>
+
+using testing::_;
+using testing::InSequence;
+
+static std::vector<uint16_t> sequence_actions;
+
+extern "C" {
+#include "tickless_idle.h"
+
+void advance_time(uint32_t ms);
+
+void process_leader_sequence(uint16_t index) {
+    sequence_actions.push_back(index);
+}
+
+LEADER_EXTERNS();
+
+void leader_end(void) {
+    // A sequence that is not in the table, checked the usual way
+    SEQ_TWO_KEYS(KC_D, KC_Q) {
+        sequence_actions.push_back(UINT16_MAX - 1);
+    }
+    sequence_actions.push_back(UINT16_MAX);
+}
+}
+
+#define LEADER_END UINT16_MAX
+#define SEQ_D_Q (UINT16_MAX - 1)
+
+class Leader : public TestFixture {
+   public:
+    KeymapKey leader_key = KeymapKey(0, 0, 0, KC_LEAD);
+    KeymapKey a_key      = KeymapKey(0, 1, 0, KC_A);
+    KeymapKey d_key      = KeymapKey(0, 2, 0, KC_D);
+    KeymapKey f_key      = KeymapKey(0, 3, 0, KC_F);
+    KeymapKey q_key      = KeymapKey(0, 4, 0, KC_Q);
+    KeymapKey s_key      = KeymapKey(0, 5, 0, KC_S);
+
+    void SetUp() override {
+        sequence_actions.clear();
+        set_keymap({leader_key, a_key, d_key, f_key, q_key, s_key});
+    }
+};
+
+TEST_F(Leader, unambiguous_sequence_fires_without_waiting) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(leader_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(f_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END}));
+
+    /* The sequence has ended, keys are sent as usual */
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(f_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Leader, prefix_of_a_longer_sequence_fires_on_timeout) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, d_key, d_key);
+    idle_for(LEADER_TIMEOUT - 10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_TRUE(sequence_actions.empty());
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(20);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END}));
+}
+
+TEST_F(Leader, longer_sequence_fires_when_complete) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, d_key, d_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(s_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END}));
+}
+
+TEST_F(Leader, action_sequence_calls_process_leader_sequence) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, a_key, s_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END, 2}));
+}
+
+TEST_F(Leader, sequence_not_in_the_table_waits_for_the_timeout) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, d_key, q_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_TRUE(sequence_actions.empty());
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(LEADER_TIMEOUT);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({SEQ_D_Q, LEADER_END}));
+
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(q_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Leader, incomplete_sequence_times_out) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, d_key);
+    idle_for(LEADER_TIMEOUT);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END}));
+}
+
+TEST_F(Leader, idle_sleep_wakes_up_for_the_timeout) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    tap_keys(leader_key, d_key);
+    const uint32_t deadline = tickless_idle_next_deadline();
+    EXPECT_LE(TIMER_DIFF_32(deadline, timer_read32()), LEADER_TIMEOUT + 1);
+
+    /* Sleep until the deadline, then run a single iteration */
+    advance_time(TIMER_DIFF_32(deadline, timer_read32()));
+    keyboard_task();
+    EXPECT_EQ(sequence_actions, std::vector<uint16_t>({LEADER_END}));
+    EXPECT_EQ(tickless_idle_next_deadline(), timer_read32() + TICKLESS_IDLE_POLL_INTERVAL);
+}
@@ -0,0 +1,26 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "ws2812.h"
+#include "virtser.h"
+
+// The handlers only need somewhere to send their output
+void rgblight_set(void) {}
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {}
+void virtser_init(void) {}
+void virtser_send(const uint8_t byte) {}
+
+static bool breathing = false;
+
+void breathing_enable(void) {
+    breathing = true;
+}
+
+void breathing_disable(void) {
+    breathing = false;
+}
+
+bool is_breathing(void) {
+    return breathing;
+}
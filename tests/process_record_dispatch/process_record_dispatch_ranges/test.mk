@@ -0,0 +1,11 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Handlers whose features build on the test platform, with their hardware stubbed out
+RGBLIGHT_ENABLE = yes
+RGBLIGHT_DRIVER = custom
+BACKLIGHT_ENABLE = yes
+BACKLIGHT_DRIVER = custom
+STENO_ENABLE = yes
+
+SRC += drivers.c
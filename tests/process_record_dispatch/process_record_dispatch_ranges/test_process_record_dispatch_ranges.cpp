@@ -0,0 +1,127 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+#include <vector>
+
+extern "C" {
+static uint32_t steno_user_calls = 0;
+
+bool process_steno_user(uint16_t keycode, keyrecord_t *record) {
+    steno_user_calls++;
+    // Keeps the chord from being sent, only reaching the handler matters here
+    return false;
+}
+}
+
+using testing::_;
+
+struct KeycodeRange {
+    uint16_t first;
+    uint16_t last;
+};
+
+class ProcessRecordDispatchRanges : public TestFixture {
+   public:
+    /* Feeds every keycode outside the ranges to the handler, which must let them all through without doing anything */
+    template <typename Handler>
+    void expect_ignores_other_keycodes(Handler handler, const std::vector<KeycodeRange> &ranges) {
+        TestDriver driver;
+        EXPECT_NO_REPORT(driver);
+
+        const uint32_t rgblight_mode     = rgblight_get_mode();
+        const bool     rgblight_enabled  = rgblight_is_enabled();
+        const uint8_t  backlight_level   = get_backlight_level();
+        const bool     backlight_breathe = is_backlight_breathing();
+        const uint32_t steno_calls       = steno_user_calls;
+
+        for (uint32_t keycode = 0; keycode <= UINT16_MAX; keycode++) {
+            bool in_range = false;
+            for (auto &range : ranges) {
+                in_range |= keycode >= range.first && keycode <= range.last;
+            }
+            if (in_range) {
+                continue;
+            }
+
+            for (bool pressed : {true, false}) {
+                // A time of 0 marks an empty event, which steno ignores whatever the keycode
+                keyrecord_t record = {.event = {.key = {.col = 0, .row = 0}, .pressed = pressed, .time = (uint16_t)(timer_read() | 1)}};
+                EXPECT_TRUE(handler(keycode, &record)) << "keycode 0x" << std::hex << keycode;
+            }
+        }
+
+        EXPECT_EQ(rgblight_get_mode(), rgblight_mode);
+        EXPECT_EQ(rgblight_is_enabled(), rgblight_enabled);
+        EXPECT_EQ(get_backlight_level(), backlight_level);
+        EXPECT_EQ(is_backlight_breathing(), backlight_breathe);
+        EXPECT_EQ(steno_user_calls, steno_calls);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    /* Taps the keycode through the whole of process_record(), returning whether the handler under test reacted */
+    template <typename Effect>
+    bool tap_reaches_handler(uint16_t keycode, Effect effect) {
+        TestDriver driver;
+        auto       key = KeymapKey(0, 0, 0, keycode);
+
+        set_keymap({key});
+        // Keycodes next to a range belong to other features, which may well send something
+        EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+
+        const auto before = effect();
+        tap_key(key);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        return effect() != before;
+    }
+};
+
+TEST_F(ProcessRecordDispatchRanges, handlers_only_act_on_their_keycodes) {
+    expect_ignores_other_keycodes(process_rgb, {RGB_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_backlight, {BACKLIGHT_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_steno, {STENO_KEYCODE_RANGES});
+}
+
+TEST_F(ProcessRecordDispatchRanges, rgb_range_boundaries) {
+    auto rgb_state = [] { return std::make_pair(rgblight_get_mode(), rgblight_is_enabled()); };
+
+    EXPECT_TRUE(tap_reaches_handler(RGB_TOG, rgb_state));
+    EXPECT_FALSE(tap_reaches_handler(RGB_TOG - 1, rgb_state));
+
+    rgblight_enable_noeeprom();
+    EXPECT_TRUE(tap_reaches_handler(RGB_MODE_RGBTEST, rgb_state));
+    EXPECT_EQ(rgblight_get_mode(), RGBLIGHT_MODE_RGB_TEST);
+    EXPECT_FALSE(tap_reaches_handler(RGB_MODE_RGBTEST + 1, rgb_state));
+
+    EXPECT_TRUE(tap_reaches_handler(RGB_MODE_TWINKLE, rgb_state));
+    EXPECT_EQ(rgblight_get_mode(), RGBLIGHT_MODE_TWINKLE);
+    EXPECT_FALSE(tap_reaches_handler(RGB_MODE_TWINKLE - 1, rgb_state));
+    EXPECT_FALSE(tap_reaches_handler(RGB_MODE_TWINKLE + 1, rgb_state));
+}
+
+TEST_F(ProcessRecordDispatchRanges, backlight_range_boundaries) {
+    auto backlight_state = [] { return std::make_pair(get_backlight_level(), is_backlight_breathing()); };
+
+    backlight_level_noeeprom(0);
+    EXPECT_TRUE(tap_reaches_handler(BL_ON, backlight_state));
+    EXPECT_EQ(get_backlight_level(), BACKLIGHT_LEVELS);
+    EXPECT_FALSE(tap_reaches_handler(BL_ON - 1, backlight_state));
+
+    EXPECT_TRUE(tap_reaches_handler(BL_BRTG, backlight_state));
+    EXPECT_FALSE(tap_reaches_handler(BL_BRTG + 1, backlight_state));
+}
+
+TEST_F(ProcessRecordDispatchRanges, steno_range_boundaries) {
+    auto steno_calls = [] { return steno_user_calls; };
+
+    EXPECT_TRUE(tap_reaches_handler(QK_STENO, steno_calls));
+    EXPECT_FALSE(tap_reaches_handler(QK_STENO - 1, steno_calls));
+    EXPECT_TRUE(tap_reaches_handler(QK_STENO_MAX, steno_calls));
+    EXPECT_FALSE(tap_reaches_handler(QK_STENO_MAX + 1, steno_calls));
+}
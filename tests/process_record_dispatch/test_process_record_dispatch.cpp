@@ -0,0 +1,103 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+#include <vector>
+
+extern "C" {
+#include "programmable_button.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+struct KeycodeRange {
+    uint16_t first;
+    uint16_t last;
+};
+
+class ProcessRecordDispatch : public TestFixture {
+   public:
+    /* Feeds every keycode outside the ranges to the handler, which must let them all through without doing anything */
+    template <typename Handler>
+    void expect_ignores_other_keycodes(Handler handler, const std::vector<KeycodeRange> &ranges) {
+        TestDriver driver;
+        EXPECT_NO_REPORT(driver);
+
+        const uint8_t  mods          = get_mods();
+        const uint16_t keymap_config = eeconfig_read_keymap();
+        const uint16_t tapping_term  = g_tapping_term;
+        const bool     sequencer_on  = is_sequencer_on();
+        const uint32_t buttons       = programmable_button_get_report();
+
+        for (uint32_t keycode = 0; keycode <= UINT16_MAX; keycode++) {
+            bool in_range = false;
+            for (auto &range : ranges) {
+                in_range |= keycode >= range.first && keycode <= range.last;
+            }
+            if (in_range) {
+                continue;
+            }
+
+            for (bool pressed : {true, false}) {
+                keyrecord_t record = {.event = {.key = {.col = 0, .row = 0}, .pressed = pressed, .time = (uint16_t)(timer_read() | 1)}};
+                EXPECT_TRUE(handler(keycode, &record)) << "keycode 0x" << std::hex << keycode;
+            }
+        }
+
+        EXPECT_EQ(get_mods(), mods);
+        EXPECT_EQ(eeconfig_read_keymap(), keymap_config);
+        EXPECT_EQ(g_tapping_term, tapping_term);
+        EXPECT_EQ(is_sequencer_on(), sequencer_on);
+        EXPECT_EQ(programmable_button_get_report(), buttons);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+};
+
+TEST_F(ProcessRecordDispatch, handlers_only_act_on_their_keycodes) {
+    expect_ignores_other_keycodes(process_grave_esc, {GRAVE_ESC_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_magic, {MAGIC_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_dynamic_tapping_term, {DYNAMIC_TAPPING_TERM_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_programmable_button, {PROGRAMMABLE_BUTTON_KEYCODE_RANGES});
+    expect_ignores_other_keycodes(process_sequencer, {SEQUENCER_KEYCODE_RANGES});
+}
+
+TEST_F(ProcessRecordDispatch, keycodes_in_range_reach_their_handler) {
+    TestDriver driver;
+    InSequence s;
+    auto       grave_esc_key = KeymapKey(0, 0, 0, QK_GRAVE_ESCAPE);
+    auto       tapping_key   = KeymapKey(0, 1, 0, DT_UP);
+    auto       sequencer_key = KeymapKey(0, 2, 0, SQ_TOG);
+    auto       regular_key   = KeymapKey(0, 3, 0, KC_A);
+
+    set_keymap({grave_esc_key, tapping_key, sequencer_key, regular_key});
+
+    EXPECT_REPORT(driver, (KC_ESCAPE));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(grave_esc_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    const uint16_t tapping_term = g_tapping_term;
+    EXPECT_NO_REPORT(driver);
+    tap_key(tapping_key);
+    EXPECT_EQ(g_tapping_term, tapping_term + DYNAMIC_TAPPING_TERM_INCREMENT);
+    g_tapping_term = tapping_term;
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    const bool sequencer_on = is_sequencer_on();
+    EXPECT_NO_REPORT(driver);
+    tap_key(sequencer_key);
+    EXPECT_NE(is_sequencer_on(), sequencer_on);
+    sequencer_toggle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(regular_key);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
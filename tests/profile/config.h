@@ -0,0 +1,9 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// The timings are read by the tests, they must not be reset by the console dump
+#define PROFILE_PRINT_INTERVAL 0
@@ -0,0 +1,94 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "profile.h"
+}
+
+/* Spins for at least `ns` of the profile clock, which is the host's clock on the test platform */
+static void busy_handler(uint32_t ns) {
+    const uint32_t start = profile_timestamp();
+    while (profile_timestamp() - start < ns) {
+    }
+}
+
+static bool busy_bool_handler(uint32_t ns) {
+    busy_handler(ns);
+    return true;
+}
+
+static const profile_probe_t *find_probe(const char *name) {
+    for (uint8_t i = 0; i < profile_probe_count(); i++) {
+        const profile_probe_t *probe = profile_probe_get(i);
+        if (strcmp(probe->name, name) == 0) {
+            return probe;
+        }
+    }
+    return nullptr;
+}
+
+class Profile : public TestFixture {
+   public:
+    void SetUp() override {
+        profile_reset();
+    }
+};
+
+TEST_F(Profile, handler_under_profile_call_is_counted_and_timed) {
+    for (int i = 0; i < 3; i++) {
+        PROFILE_CALL(busy_handler, 100000);
+    }
+
+    const profile_probe_t *probe = find_probe("busy_handler");
+    ASSERT_NE(probe, nullptr);
+    EXPECT_EQ(probe->count, 3);
+    EXPECT_GE(probe->min, 100000);
+    EXPECT_GE(probe->max, probe->min);
+    EXPECT_GE(probe->total, 3 * (uint64_t)probe->min);
+    EXPECT_LE(probe->total, 3 * (uint64_t)probe->max);
+}
+
+TEST_F(Profile, profile_call_bool_returns_the_result) {
+    EXPECT_TRUE(PROFILE_CALL_BOOL(busy_bool_handler, 1000));
+
+    const profile_probe_t *probe = find_probe("busy_bool_handler");
+    ASSERT_NE(probe, nullptr);
+    EXPECT_EQ(probe->count, 1);
+    EXPECT_GE(probe->min, 1000);
+}
+
+TEST_F(Profile, keyboard_task_handlers_are_counted_once_per_scan) {
+    TestDriver driver;
+
+    for (int i = 0; i < 10; i++) {
+        run_one_scan_loop();
+    }
+
+    const profile_probe_t *matrix = find_probe("matrix_task");
+    ASSERT_NE(matrix, nullptr);
+    EXPECT_EQ(matrix->count, 10);
+    EXPECT_LE(matrix->min, matrix->max);
+
+    const profile_probe_t *quantum = find_probe("quantum_task");
+    ASSERT_NE(quantum, nullptr);
+    EXPECT_EQ(quantum->count, 10);
+}
+
+TEST_F(Profile, reset_clears_the_timings_but_keeps_the_probes) {
+    PROFILE_CALL(busy_handler, 1000);
+    const uint8_t probes = profile_probe_count();
+
+    profile_reset();
+
+    EXPECT_EQ(profile_probe_count(), probes);
+    const profile_probe_t *probe = find_probe("busy_handler");
+    ASSERT_NE(probe, nullptr);
+    EXPECT_EQ(probe->count, 0);
+    EXPECT_EQ(probe->max, 0);
+    EXPECT_EQ(probe->total, 0);
+}
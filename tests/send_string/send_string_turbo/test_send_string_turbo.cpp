@@ -0,0 +1,138 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "process_unicode_common.h"
+#include "keymap_extras/keymap_french.h"
+#include "send_string.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class SendStringTurbo : public TestFixture {};
+
+TEST_F(SendStringTurbo, next_key_is_pressed_as_the_last_one_is_released) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string("abc");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, shift_is_pressed_with_the_key) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_H));
+    // The H must not be seen without shift
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_I));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string("Hi");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, repeated_key_is_released_first) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_H));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_E));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_L));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_L));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_O));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string("HELLO");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, key_is_released_before_tap_code_sequences) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_F1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    SEND_STRING("a" SS_TAP(X_F1) "b");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, key_is_released_before_the_interval) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string_with_delay("ab", 5);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, send_char_releases_its_key) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    send_char('A');
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, unicode_hex_digits_are_pipelined) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_0));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_0));
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_REPORT(driver, (KC_9));
+    EXPECT_EMPTY_REPORT(driver);
+    register_hex(0x00e9);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, keycodes_of_other_layouts_are_typed_with_their_modifiers) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_C));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    // "Café" with the French layout
+    SEND_KEYCODES(S(FR_C), FR_A, FR_F, FR_EACU);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringTurbo, moved_keys_are_typed_with_altgr) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_NONUS_BACKSLASH));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_RIGHT_ALT, KC_0));
+    EXPECT_REPORT(driver, (KC_RIGHT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_NONUS_BACKSLASH));
+    EXPECT_EMPTY_REPORT(driver);
+    // "<@>" with the French layout
+    SEND_KEYCODES(FR_LABK, FR_AT, FR_RABK);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,99 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "keymap_extras/keymap_french.h"
+#include "send_string.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+// There is no bit for the side of Alt, the Option key of the macOS layouts is packed as AltGr
+static_assert(SEND_KEYCODES_BYTE(LALT(KC_A)) == SEND_KEYCODES_BYTE(RALT(KC_A)), "Left Alt is packed as AltGr");
+static_assert(SEND_KEYCODES_BYTE(S(RALT(KC_A))) == (0x80 | 0x40 | KC_A), "Shift and AltGr are packed into the top bits");
+
+class SendString : public TestFixture {};
+
+TEST_F(SendString, each_character_is_pressed_and_released) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string("ab");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendString, shifted_characters_press_shift_first) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_H));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_I));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string("Hi");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendString, tap_code_sequences_are_sent_between_characters) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_F1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    SEND_STRING("a" SS_TAP(X_F1) "b");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendString, keycodes_of_other_layouts_are_typed_with_their_modifiers) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_C));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    // "Café" with the French layout
+    SEND_KEYCODES(S(FR_C), FR_A, FR_F, FR_EACU);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendString, keycodes_are_packed_into_a_byte_each) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_NONUS_BACKSLASH));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_RIGHT_ALT));
+    EXPECT_REPORT(driver, (KC_RIGHT_ALT, KC_0));
+    EXPECT_REPORT(driver, (KC_RIGHT_ALT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_NONUS_BACKSLASH));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    // "<@>" with the French layout
+    SEND_KEYCODES(FR_LABK, FR_AT, FR_RABK);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,216 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <deque>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "host.h"
+#include "sof_sync.h"
+}
+
+/* A USB host polling the keyboard endpoint once every `interval` frames. The reports handed to the driver wait in the
+ * endpoint until the host reads them, one per poll. */
+class SimulatedHost {
+   public:
+    struct Read {
+        uint32_t          time;
+        report_keyboard_t report;
+    };
+
+    SimulatedHost(uint8_t interval, bool signals_frames) : m_interval(interval), m_signals_frames(signals_frames) {
+        m_this = this;
+        host_set_driver(&m_driver);
+        // Like a keyboard plugged into a new host
+        sof_sync_reset();
+    }
+
+    ~SimulatedHost() {
+        host_set_driver(nullptr);
+        m_this = nullptr;
+    }
+
+    /* Starts a frame, which the host polls in at the start if it is one of its polling frames */
+    void frame() {
+        m_frame++;
+        if (m_signals_frames) {
+            sof_sync_start_of_frame();
+        }
+        if (m_frame % m_interval == 0 && !m_endpoint.empty()) {
+            reads.push_back({timer_read32(), m_endpoint.front()});
+            m_endpoint.pop_front();
+            if (m_signals_frames) {
+                sof_sync_keyboard_read();
+            }
+        }
+    }
+
+    bool idle() const {
+        return m_endpoint.empty();
+    }
+
+    std::vector<Read> reads;
+
+   private:
+    static uint8_t keyboard_leds(void) {
+        return 0;
+    }
+    static void send_keyboard(report_keyboard_t *report) {
+        m_this->m_endpoint.push_back(*report);
+    }
+    static void send_mouse(report_mouse_t *report) {}
+    static void send_system(uint16_t data) {}
+    static void send_consumer(uint16_t data) {}
+
+    host_driver_t                 m_driver{keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+    uint8_t                       m_interval;
+    bool                          m_signals_frames;
+    uint32_t                      m_frame = 0;
+    std::deque<report_keyboard_t> m_endpoint;
+    static SimulatedHost         *m_this;
+};
+
+SimulatedHost *SimulatedHost::m_this = nullptr;
+
+struct KeyChange {
+    uint32_t  time;
+    KeymapKey key;
+    bool      pressed;
+};
+
+struct Latencies {
+    uint32_t total = 0;
+    uint32_t max   = 0;
+    uint32_t count = 0;
+    size_t   reads = 0;
+};
+
+class SofSync : public TestFixture {
+   public:
+    void run_frame(SimulatedHost &host) {
+        host.frame();
+        run_one_scan_loop();
+    }
+
+    /* Plays the key changes starting `offset` frames after a poll, then checks that the host saw every change in order
+     * and adds up how long each change took to reach it */
+    void play(SimulatedHost &host, const std::vector<KeyChange> &changes, uint8_t offset, Latencies &latencies) {
+        // Something has to be read for the polling to be tracked
+        auto warm_up = KeymapKey(0, 9, 3, KC_Z);
+        warm_up.press();
+        while (host.reads.empty()) {
+            run_frame(host);
+        }
+        warm_up.release();
+        while (host.reads.size() < 2 || !host.idle()) {
+            run_frame(host);
+        }
+        for (uint32_t since_poll = timer_read32() - host.reads.back().time; since_poll != offset; since_poll = (since_poll + 1) % interval) {
+            run_frame(host);
+        }
+
+        const uint32_t start      = timer_read32();
+        const size_t   first_read = host.reads.size();
+        for (auto change : changes) {
+            while (timer_read32() < start + change.time) {
+                run_frame(host);
+            }
+            change.pressed ? change.key.press() : change.key.release();
+        }
+        // Held back reports go out within a polling interval
+        for (int i = 0; i < interval || !host.idle(); i++) {
+            run_frame(host);
+        }
+
+        size_t read = first_read;
+        for (auto &change : changes) {
+            while (read < host.reads.size() && is_key_pressed(&host.reads[read].report, change.key.code) != change.pressed) {
+                read++;
+            }
+            ASSERT_LT(read, host.reads.size()) << "Change of " << change.key.code << " at " << change.time << " was lost";
+
+            const uint32_t latency = host.reads[read].time - (start + change.time);
+            latencies.total += latency;
+            latencies.max = std::max(latencies.max, latency);
+            latencies.count++;
+        }
+        latencies.reads += host.reads.size() - first_read;
+        EXPECT_FALSE(has_anykey(&host.reads.back().report));
+    }
+
+    static const uint8_t interval = USB_POLLING_INTERVAL_MS;
+};
+
+TEST_F(SofSync, typing_reaches_the_host_sooner) {
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+    auto key_b = KeymapKey(0, 1, 0, KC_B);
+    auto key_c = KeymapKey(0, 2, 0, KC_C);
+    auto key_d = KeymapKey(0, 3, 0, KC_D);
+    auto key_e = KeymapKey(0, 4, 0, KC_E);
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e, KeymapKey(0, 9, 3, KC_Z)});
+
+    // Fast typing with some rollover
+    const std::vector<KeyChange> changes = {
+        {0, key_a, true}, {3, key_b, true}, {5, key_a, false}, {6, key_c, true}, {9, key_b, false}, {12, key_c, false}, {13, key_d, true}, {20, key_d, false}, {21, key_e, true}, {23, key_e, false},
+    };
+
+    Latencies polled, synced;
+    for (uint8_t offset = 0; offset < interval; offset++) {
+        {
+            SimulatedHost host(interval, false);
+            play(host, changes, offset, polled);
+        }
+        {
+            SimulatedHost host(interval, true);
+            play(host, changes, offset, synced);
+        }
+        // Lets the tracking time out between runs
+        idle_for(10);
+    }
+
+    test_logger.info() << "polled: " << polled.total / polled.count << "ms average, " << polled.max << "ms max, " << polled.reads << " reads" << std::endl;
+    test_logger.info() << "synced: " << synced.total / synced.count << "ms average, " << synced.max << "ms max, " << synced.reads << " reads" << std::endl;
+    EXPECT_LT(synced.total, polled.total);
+    EXPECT_LE(synced.max, polled.max);
+    EXPECT_LT(synced.reads, polled.reads);
+}
+
+TEST_F(SofSync, report_is_handed_over_the_frame_before_the_poll) {
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a, KeymapKey(0, 9, 3, KC_Z)});
+
+    SimulatedHost host(interval, true);
+    Latencies     latencies;
+    play(host, {{0, key_a, true}, {1, key_a, false}}, 1, latencies);
+
+    EXPECT_LE(latencies.max, interval * 2);
+
+    // Nothing is held back, so there is nothing to wake up for
+    uint32_t deadline;
+    EXPECT_FALSE(sof_sync_next_deadline(&deadline));
+
+    // Right after a poll, the press is held back until the frame before the next one
+    while ((timer_read32() - host.reads.back().time) % interval != 1) {
+        run_frame(host);
+    }
+    const uint32_t poll = timer_read32() - 1;
+    key_a.press();
+    run_frame(host);
+    ASSERT_TRUE(sof_sync_next_deadline(&deadline));
+    EXPECT_EQ(deadline, poll + interval - 1);
+
+    key_a.release();
+    for (int i = 0; i < interval * 2; i++) {
+        run_frame(host);
+    }
+    EXPECT_TRUE(host.idle());
+    EXPECT_FALSE(has_anykey(&host.reads.back().report));
+
+    idle_for(10);
+}
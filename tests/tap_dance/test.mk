@@ -20,3 +20,6 @@
 TAP_DANCE_ENABLE = yes
 
 SRC += examples.c
+
+# Lets idle_for() skip the scans where nothing is due
+TEST_VIRTUAL_CLOCK = yes
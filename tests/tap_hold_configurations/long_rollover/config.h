@@ -0,0 +1,10 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// Room for the 20 events of a 10 key rollover, plus a few more
+#define WAITING_BUFFER_SIZE 24
+#define IGNORE_MOD_TAP_INTERRUPT
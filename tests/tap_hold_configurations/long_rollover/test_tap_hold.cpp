@@ -0,0 +1,116 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+#include <vector>
+
+using testing::_;
+using testing::InSequence;
+
+class LongRollover : public TestFixture {
+   public:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        const uint16_t codes[] = {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L};
+        keys.clear();
+        for (uint8_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++) {
+            keys.push_back(KeymapKey(0, i % MATRIX_COLS, 1 + i / MATRIX_COLS, codes[i]));
+        }
+    }
+
+    /* Rolls over the keys, each one is released after the next one is pressed */
+    void roll(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            keys[i].press();
+            run_one_scan_loop();
+            if (i > 0) {
+                keys[i - 1].release();
+                run_one_scan_loop();
+            }
+        }
+        keys[count - 1].release();
+        run_one_scan_loop();
+    }
+
+    /* The reports of roll(), on top of the given modifiers or keys */
+    void expect_roll(TestDriver &driver, size_t count, uint16_t held = KC_NO) {
+        for (size_t i = 0; i < count; i++) {
+            if (i == 0) {
+                expect_keys(driver, held, {(uint8_t)keys[i].code});
+            } else {
+                expect_keys(driver, held, {(uint8_t)keys[i - 1].code, (uint8_t)keys[i].code});
+                expect_keys(driver, held, {(uint8_t)keys[i].code});
+            }
+        }
+        expect_keys(driver, held, {});
+    }
+
+    void expect_keys(TestDriver &driver, uint16_t held, std::vector<uint8_t> codes) {
+        if (held != KC_NO) {
+            codes.insert(codes.begin(), held);
+        }
+        EXPECT_CALL(driver, send_keyboard_mock(testing::MakeMatcher(new KeyboardReportMatcher(codes))));
+    }
+};
+
+TEST_F(LongRollover, ten_key_rollover_while_mod_tap_key_is_held_is_a_tap) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    for (auto &key : keys) {
+        add_key(key);
+    }
+    add_key(mod_tap_hold_key);
+
+    /* Press mod-tap-hold key, then roll over ten keys. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    roll(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key within the tapping term, every key comes through in order. */
+    EXPECT_REPORT(driver, (KC_P));
+    expect_roll(driver, 10, KC_P);
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LongRollover, ten_key_rollover_while_mod_tap_key_is_held_past_tapping_term) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    for (auto &key : keys) {
+        add_key(key);
+    }
+    add_key(mod_tap_hold_key);
+
+    /* Press mod-tap-hold key, then roll over ten keys. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    roll(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Once the tapping term has passed, every key comes through shifted. */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    expect_roll(driver, 10, KC_LSFT);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,119 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_reference.h"
+#include "host.h"
+#include "keycode.h"
+#include "keycode_config.h"
+#include "util.h"
+#include <string.h>
+
+static bool nkro_enabled(void) {
+#ifdef NKRO_ENABLE
+    return keyboard_protocol && keymap_config.nkro;
+#else
+    return false;
+#endif
+}
+
+uint8_t reference_has_anykey(report_keyboard_t* keyboard_report) {
+    uint8_t  cnt = 0;
+    uint8_t* p   = keyboard_report->keys;
+    uint8_t  lp  = sizeof(keyboard_report->keys);
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        p  = keyboard_report->nkro.bits;
+        lp = sizeof(keyboard_report->nkro.bits);
+    }
+#endif
+    while (lp--) {
+        if (*p++) cnt++;
+    }
+    return cnt;
+}
+
+uint8_t reference_get_first_key(report_keyboard_t* keyboard_report) {
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        uint8_t i = 0;
+        for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
+            ;
+        // The original read past the bitmap when it was empty
+        return i < KEYBOARD_REPORT_BITS ? (i << 3 | biton(keyboard_report->nkro.bits[i])) : 0;
+    }
+#endif
+    return keyboard_report->keys[0];
+}
+
+bool reference_is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
+    if (key == KC_NO) {
+        return false;
+    }
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        if ((key >> 3) < KEYBOARD_REPORT_BITS) {
+            return keyboard_report->nkro.bits[key >> 3] & 1 << (key & 7);
+        } else {
+            return false;
+        }
+    }
+#endif
+    for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void reference_add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key) {
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        if ((key >> 3) < KEYBOARD_REPORT_BITS) {
+            keyboard_report->nkro.bits[key >> 3] |= 1 << (key & 7);
+        }
+        return;
+    }
+#endif
+    int8_t i     = 0;
+    int8_t empty = -1;
+    for (; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == key) {
+            break;
+        }
+        if (empty == -1 && keyboard_report->keys[i] == 0) {
+            empty = i;
+        }
+    }
+    if (i == KEYBOARD_REPORT_KEYS) {
+        if (empty != -1) {
+            keyboard_report->keys[empty] = key;
+        }
+    }
+}
+
+void reference_del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        if ((key >> 3) < KEYBOARD_REPORT_BITS) {
+            keyboard_report->nkro.bits[key >> 3] &= ~(1 << (key & 7));
+        }
+        return;
+    }
+#endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == key) {
+            keyboard_report->keys[i] = 0;
+        }
+    }
+}
+
+void reference_clear_keys_from_report(report_keyboard_t* keyboard_report) {
+#ifdef NKRO_ENABLE
+    if (nkro_enabled()) {
+        memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
+        return;
+    }
+#endif
+    memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
+}
@@ -0,0 +1,26 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The byte by byte keyboard report functions that report.c used to have, for tests and benchmarks to compare against.
+ * Only the 6KRO and NKRO reports are covered, not the ring buffered 6KRO report. */
+
+uint8_t reference_has_anykey(report_keyboard_t* keyboard_report);
+uint8_t reference_get_first_key(report_keyboard_t* keyboard_report);
+bool    reference_is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key);
+void    reference_add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
+void    reference_del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
+void    reference_clear_keys_from_report(report_keyboard_t* keyboard_report);
+
+#ifdef __cplusplus
+}
+#endif
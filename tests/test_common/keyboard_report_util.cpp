@@ -17,14 +17,34 @@
 #include "keyboard_report_util.hpp"
 #include <vector>
 #include <algorithm>
+extern "C" {
+#include "host.h"
+#include "keycode_config.h"
+}
 using namespace testing;
 
 namespace {
+bool is_nkro(void) {
+#if defined(NKRO_ENABLE)
+    return keyboard_protocol && keymap_config.nkro;
+#else
+    return false;
+#endif
+}
+
 std::vector<uint8_t> get_keys(const report_keyboard_t& report) {
     std::vector<uint8_t> result;
 #if defined(NKRO_ENABLE)
-#    error NKRO support not implemented yet
-#elif defined(RING_BUFFERED_6KRO_REPORT_ENABLE)
+    if (is_nkro()) {
+        for (size_t i = 0; i < KEYBOARD_REPORT_BITS * 8; i++) {
+            if (report.nkro.bits[i >> 3] & 1 << (i & 7)) {
+                result.emplace_back(i);
+            }
+        }
+        return result;
+    }
+#endif
+#if defined(RING_BUFFERED_6KRO_REPORT_ENABLE)
 #    error 6KRO support not implemented yet
 #else
     for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -36,19 +56,28 @@ std::vector<uint8_t> get_keys(const report_keyboard_t& report) {
     std::sort(result.begin(), result.end());
     return result;
 }
+
+uint8_t get_mods(const report_keyboard_t& report) {
+#if defined(NKRO_ENABLE)
+    if (is_nkro()) {
+        return report.nkro.mods;
+    }
+#endif
+    return report.mods;
+}
 } // namespace
 
 bool operator==(const report_keyboard_t& lhs, const report_keyboard_t& rhs) {
     auto lhskeys = get_keys(lhs);
     auto rhskeys = get_keys(rhs);
-    return lhs.mods == rhs.mods && lhskeys == rhskeys;
+    return get_mods(lhs) == get_mods(rhs) && lhskeys == rhskeys;
 }
 
 std::ostream& operator<<(std::ostream& stream, const report_keyboard_t& report) {
     auto keys = get_keys(report);
 
     // TODO: This should probably print friendly names for the keys
-    stream << "Keyboard Report: Mods (" << (uint32_t)report.mods << ") Keys (";
+    stream << "Keyboard Report: Mods (" << (uint32_t)get_mods(report) << ") Keys (";
 
     for (auto key = keys.cbegin(); key != keys.cend();) {
         stream << +(*key);
@@ -66,6 +95,9 @@ KeyboardReportMatcher::KeyboardReportMatcher(const std::vector<uint8_t>& keys) {
     for (auto k : keys) {
         if (IS_MOD(k)) {
             m_report.mods |= MOD_BIT(k);
+#if defined(NKRO_ENABLE)
+            m_report.nkro.mods = m_report.mods;
+#endif
         } else {
             add_key_to_report(&m_report, k);
         }
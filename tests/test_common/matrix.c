@@ -25,6 +25,11 @@ void matrix_init(void) {
     matrix_init_quantum();
 }
 
+bool matrix_scan_keys(void) {
+    // Keys are pressed and released directly on the matrix
+    return true;
+}
+
 uint8_t matrix_scan(void) {
     matrix_scan_quantum();
     return 1;
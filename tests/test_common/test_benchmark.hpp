@@ -0,0 +1,56 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "gtest/gtest.h"
+
+/* Minimum time each benchmark runs for, longer runs give steadier results */
+#ifndef BENCHMARK_MIN_TIME_MS
+#    define BENCHMARK_MIN_TIME_MS 100
+#endif
+
+/**
+ * @brief Calls `op` in batches of growing size until BENCHMARK_MIN_TIME_MS have passed.
+ *
+ * The time per call is printed, and recorded as the "ns_per_op" and "iterations" properties of the current test, which
+ * `make bench` writes to the JSON results. Use one benchmark per test.
+ *
+ * @return nanoseconds per call
+ */
+template <typename Op>
+double benchmark(Op&& op) {
+    using clock = std::chrono::steady_clock;
+
+    // Warm up the caches and any lazily built state
+    op();
+
+    uint64_t        iterations = 0;
+    uint64_t        batch      = 1;
+    clock::duration elapsed{};
+    while (elapsed < std::chrono::milliseconds(BENCHMARK_MIN_TIME_MS)) {
+        const auto start = clock::now();
+        for (uint64_t i = 0; i < batch; i++) {
+            op();
+        }
+        elapsed += clock::now() - start;
+        iterations += batch;
+        batch *= 2;
+    }
+
+    const double       ns_per_op = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    std::ostringstream formatted;
+    formatted << std::fixed << std::setprecision(1) << ns_per_op;
+
+    const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::cout << "[ BENCH    ] " << test_info->test_suite_name() << "." << test_info->name() << ": " << formatted.str() << "ns per op, " << iterations << " iterations" << std::endl;
+    ::testing::Test::RecordProperty("ns_per_op", formatted.str());
+    ::testing::Test::RecordProperty("iterations", std::to_string(iterations));
+
+    return ns_per_op;
+}
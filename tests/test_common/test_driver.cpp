@@ -18,6 +18,9 @@
 
 TestDriver* TestDriver::m_this = nullptr;
 
+// The report protocol, as if the host had configured the keyboard
+uint8_t keyboard_protocol = 1;
+
 namespace {
 // Given a hex digit between 0 and 15, returns the corresponding keycode.
 uint8_t hex_digit_to_keycode(uint8_t digit) {
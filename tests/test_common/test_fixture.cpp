@@ -22,9 +22,13 @@ extern "C" {
 #include "eeconfig.h"
 #include "keyboard.h"
 #include "keymap.h"
+#ifdef KEYMAP_CACHE_ENABLE
+#    include "keymap_cache.h"
+#endif
 
 void set_time(uint32_t t);
 void advance_time(uint32_t ms);
+void advance_time_to_next_deadline(uint32_t limit);
 }
 
 using testing::_;
@@ -99,6 +103,9 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_invalidate();
+#endif
 }
 
 void TestFixture::tap_key(KeymapKey key, unsigned delay_ms) {
@@ -173,9 +180,18 @@ void TestFixture::run_one_scan_loop() {
 }
 
 void TestFixture::idle_for(unsigned time) {
+#ifdef TEST_VIRTUAL_CLOCK
+    /* Skip the scans where nothing is due, the reports are the same as when scanning every millisecond */
+    const uint32_t end = timer_read32() + time;
+    while ((int32_t)TIMER_DIFF_32(end, timer_read32()) > 0) {
+        keyboard_task();
+        advance_time_to_next_deadline(end);
+    }
+#else
     for (unsigned i = 0; i < time; i++) {
         run_one_scan_loop();
     }
+#endif
 }
 
 void TestFixture::print_test_log() const {
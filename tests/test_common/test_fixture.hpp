@@ -61,6 +61,13 @@ class TestFixture : public testing::Test {
     void tap_combo(const std::vector<KeymapKey>& chord_keys, unsigned delay_ms = 1);
 
     void run_one_scan_loop();
+
+    /**
+     * @brief Lets `ms` milliseconds pass, scanning once per millisecond.
+     *
+     * With `TEST_VIRTUAL_CLOCK = yes` in `test.mk` the clock jumps from one deadline to the next instead, so long idle
+     * periods only take a few scans.
+     */
     void idle_for(unsigned ms);
 
     void expect_layer_state(layer_t layer) const;
@@ -0,0 +1,131 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_trace_replay.hpp"
+#include <algorithm>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "test_logger.hpp"
+#include "test_matrix.h"
+
+extern "C" {
+#include "action.h"
+#include "keyboard.h"
+#include "timer.h"
+#ifdef ENCODER_ENABLE
+#    include "encoder.h"
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+#    include "pointing_device.h"
+#endif
+
+void advance_time_to_next_deadline(uint32_t limit);
+}
+
+static_assert(sizeof(keystroke_trace_event_t) == 8, "trace files are made of 8 byte records");
+
+KeystrokeTrace load_keystroke_trace(const std::string& path) {
+    KeystrokeTrace trace;
+    std::ifstream  file(path, std::ios::binary);
+    if (!file) {
+        ADD_FAILURE() << "Cannot open trace " << path;
+        return trace;
+    }
+
+    keystroke_trace_event_t event;
+    while (file.read(reinterpret_cast<char*>(&event), sizeof(event))) {
+        trace.push_back(event);
+    }
+    if (file.gcount() != 0) {
+        ADD_FAILURE() << "Trace " << path << " ends with a partial event";
+    }
+    return trace;
+}
+
+void save_keystroke_trace(const std::string& path, const KeystrokeTrace& trace) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(trace.data()), trace.size() * sizeof(keystroke_trace_event_t));
+    if (!file) {
+        ADD_FAILURE() << "Cannot write trace " << path;
+    }
+}
+
+#ifdef KEYSTROKE_TRACE_ENABLE
+KeystrokeTrace recorded_keystroke_trace() {
+    KeystrokeTrace trace(keystroke_trace_count());
+    for (uint16_t i = 0; i < trace.size(); i++) {
+        keystroke_trace_get(i, &trace[i]);
+    }
+    return trace;
+}
+#endif
+
+static void apply_event(const keystroke_trace_event_t& event) {
+    switch (event.type) {
+        case KEYSTROKE_TRACE_KEY:
+            if (event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) {
+                ADD_FAILURE() << "Key (" << +event.key.col << "," << +event.key.row << ") is outside of the test matrix";
+            } else if (event.key.pressed) {
+                press_key(event.key.col, event.key.row);
+            } else {
+                release_key(event.key.col, event.key.row);
+            }
+            break;
+        case KEYSTROKE_TRACE_ENCODER:
+#if defined(ENCODER_ENABLE) && defined(ENCODER_MAP_ENABLE)
+            action_exec(event.encoder.clockwise ? ENCODER_CW_EVENT(event.encoder.index, true) : ENCODER_CCW_EVENT(event.encoder.index, true));
+            action_exec(event.encoder.clockwise ? ENCODER_CW_EVENT(event.encoder.index, false) : ENCODER_CCW_EVENT(event.encoder.index, false));
+#elif defined(ENCODER_ENABLE)
+            encoder_update_kb(event.encoder.index, event.encoder.clockwise);
+#else
+            test_logger.info() << "Skipping encoder event, ENCODER_ENABLE is not set" << std::endl;
+#endif
+            break;
+        case KEYSTROKE_TRACE_POINTING: {
+#ifdef POINTING_DEVICE_ENABLE
+            report_mouse_t report = {.buttons = event.pointing.buttons, .x = event.pointing.x, .y = event.pointing.y, .v = event.pointing.v, .h = event.pointing.h};
+            report                = pointing_device_task_kb(pointing_device_adjust_by_defines(report));
+            pointing_device_set_report(report);
+            pointing_device_send();
+#else
+            test_logger.info() << "Skipping pointing event, POINTING_DEVICE_ENABLE is not set" << std::endl;
+#endif
+            break;
+        }
+        default:
+            ADD_FAILURE() << "Unknown trace event type " << +event.type;
+            break;
+    }
+}
+
+static void timed_scan(TraceReplayStats& stats, uint32_t limit) {
+    const auto start = std::chrono::steady_clock::now();
+    keyboard_task();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    stats.busy += elapsed;
+    stats.slowest_scan = std::max(stats.slowest_scan, elapsed);
+    stats.scans++;
+    advance_time_to_next_deadline(limit);
+}
+
+static void timed_idle_for(TraceReplayStats& stats, uint32_t ms) {
+    const uint32_t end = timer_read32() + ms;
+    while ((int32_t)TIMER_DIFF_32(end, timer_read32()) > 0) {
+        timed_scan(stats, end);
+    }
+}
+
+TraceReplayStats replay_keystroke_trace(const KeystrokeTrace& trace) {
+    TraceReplayStats stats;
+
+    for (auto& event : trace) {
+        timed_idle_for(stats, event.delta);
+        apply_event(event);
+        stats.events++;
+    }
+    // Let the last event reach the action pipeline
+    timed_idle_for(stats, 1);
+
+    return stats;
+}
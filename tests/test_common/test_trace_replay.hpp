@@ -0,0 +1,51 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "keystroke_trace.h"
+}
+
+using KeystrokeTrace = std::vector<keystroke_trace_event_t>;
+
+/**
+ * @brief Time spent in keyboard_task() while a trace was replayed, measured with the host's steady clock.
+ */
+struct TraceReplayStats {
+    size_t                   events = 0;
+    size_t                   scans  = 0;
+    std::chrono::nanoseconds busy{0};
+    std::chrono::nanoseconds slowest_scan{0};
+
+    std::chrono::nanoseconds per_event() const {
+        return events ? busy / static_cast<long>(events) : std::chrono::nanoseconds{0};
+    }
+};
+
+/**
+ * @brief Reads a trace file, as dumped from the keyboard over raw HID.
+ */
+KeystrokeTrace load_keystroke_trace(const std::string& path);
+
+void save_keystroke_trace(const std::string& path, const KeystrokeTrace& trace);
+
+#ifdef KEYSTROKE_TRACE_ENABLE
+/**
+ * @brief Copies the events recorded so far, oldest first.
+ */
+KeystrokeTrace recorded_keystroke_trace();
+#endif
+
+/**
+ * @brief Replays `trace` through the test matrix and the real action pipeline, from inside a TestFixture test.
+ *
+ * Each event is applied once its delta has passed, scanning every millisecond in between, so the events reach the
+ * action pipeline with the timing they were recorded with. With `TEST_VIRTUAL_CLOCK = yes` the scans where nothing is
+ * due are skipped, like TestFixture::idle_for() does. The reports go to the test driver as usual.
+ */
+TraceReplayStats replay_keystroke_trace(const KeystrokeTrace& trace);
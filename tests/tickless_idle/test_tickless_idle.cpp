@@ -0,0 +1,171 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "tickless_idle.h"
+
+void advance_time(uint32_t ms);
+
+static uint32_t deadline_queries = 0;
+
+bool tickless_idle_next_deadline_user(uint32_t *deadline) {
+    deadline_queries++;
+    return false;
+}
+}
+
+using testing::_;
+using testing::InvokeWithoutArgs;
+
+class TicklessIdle : public TestFixture {
+   public:
+    /* Mimics the main loop: sleep until the next deadline, then run a single iteration */
+    void sleep_then_run_one_scan_loop() {
+        const uint32_t remaining = TIMER_DIFF_32(tickless_idle_next_deadline(), timer_read32());
+        // Time still moves on while spinning
+        advance_time(remaining > 0 ? remaining : 1);
+        keyboard_task();
+    }
+};
+
+TEST_F(TicklessIdle, sleeps_for_poll_interval_when_idle) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    run_one_scan_loop();
+
+    EXPECT_EQ(tickless_idle_next_deadline(), timer_read32() + TICKLESS_IDLE_POLL_INTERVAL);
+}
+
+TEST_F(TicklessIdle, mod_tap_hold_is_reported_at_the_same_time) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_hold_key});
+
+    // Holds the key until shift is reported, returning how long that took
+    auto hold_until_shift = [&](bool tickless) {
+        uint32_t report_time = 0;
+
+        // Event times have their lowest bit forced on, start both runs with the same parity
+        if (timer_read32() & 1) {
+            run_one_scan_loop();
+        }
+
+        mod_tap_hold_key.press();
+        EXPECT_NO_REPORT(driver);
+        run_one_scan_loop();
+        const uint32_t press_time = timer_read32() - 1;
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).WillOnce(InvokeWithoutArgs([&] { report_time = timer_read32(); }));
+        while (TIMER_DIFF_32(timer_read32(), press_time) < 2 * TAPPING_TERM) {
+            if (tickless) {
+                sleep_then_run_one_scan_loop();
+            } else {
+                run_one_scan_loop();
+            }
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_EMPTY_REPORT(driver);
+        mod_tap_hold_key.release();
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        return report_time - press_time;
+    };
+
+    const uint32_t polled = hold_until_shift(false);
+    EXPECT_EQ(hold_until_shift(true), polled);
+}
+
+TEST_F(TicklessIdle, one_shot_mods_time_out_on_time) {
+    TestDriver driver;
+    auto       osm_key = KeymapKey(0, 2, 0, OSM(MOD_LSFT));
+
+    set_keymap({osm_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    tap_key(osm_key);
+    const uint32_t tap_time = timer_read32();
+
+    ASSERT_EQ(get_oneshot_mods(), MOD_BIT(KC_LSFT));
+    const uint32_t deadline = tickless_idle_next_deadline();
+    EXPECT_LE(TIMER_DIFF_32(deadline, tap_time), ONESHOT_TIMEOUT);
+
+    while (get_oneshot_mods()) {
+        sleep_then_run_one_scan_loop();
+    }
+    EXPECT_LE(TIMER_DIFF_32(timer_read32(), tap_time), ONESHOT_TIMEOUT);
+}
+
+TEST_F(TicklessIdle, deferred_executions_are_deadlines) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    run_one_scan_loop();
+
+    deferred_token token = defer_exec(
+        120, [](uint32_t trigger_time, void *cb_arg) -> uint32_t { return 0; }, nullptr);
+    EXPECT_EQ(tickless_idle_next_deadline(), timer_read32() + 120);
+
+    cancel_deferred_exec(token);
+    EXPECT_EQ(tickless_idle_next_deadline(), timer_read32() + TICKLESS_IDLE_POLL_INTERVAL);
+}
+
+TEST_F(TicklessIdle, idle_for_jumps_to_the_next_deadline) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_hold_key});
+
+    // Holds the key for a while, returning when shift was reported
+    auto hold_until_shift = [&](bool skip_idle_scans) {
+        uint32_t report_time = 0;
+
+        // Event times have their lowest bit forced on, start both runs with the same parity
+        if (timer_read32() & 1) {
+            run_one_scan_loop();
+        }
+
+        mod_tap_hold_key.press();
+        EXPECT_NO_REPORT(driver);
+        run_one_scan_loop();
+        const uint32_t press_time = timer_read32() - 1;
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        deadline_queries = 0;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).WillOnce(InvokeWithoutArgs([&] { report_time = timer_read32(); }));
+        if (skip_idle_scans) {
+            idle_for(10 * TICKLESS_IDLE_POLL_INTERVAL);
+            // Once per scan
+            EXPECT_LT(deadline_queries, 20);
+        } else {
+            for (uint32_t i = 0; i < 10 * TICKLESS_IDLE_POLL_INTERVAL; i++) {
+                run_one_scan_loop();
+            }
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        EXPECT_EQ(timer_read32(), press_time + 1 + 10 * TICKLESS_IDLE_POLL_INTERVAL);
+
+        EXPECT_EMPTY_REPORT(driver);
+        mod_tap_hold_key.release();
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        return report_time - press_time;
+    };
+
+    const uint32_t polled = hold_until_shift(false);
+    EXPECT_EQ(hold_until_shift(true), polled);
+}
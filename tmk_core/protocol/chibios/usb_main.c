@@ -54,6 +54,10 @@ extern keymap_config_t keymap_config;
 #    include "joystick.h"
 #endif
 
+#ifdef SOF_SYNC_ENABLE
+#    include "sof_sync.h"
+#endif
+
 /* ---------------------------------------------------------
  *       Global interface variables and declarations
  * ---------------------------------------------------------
@@ -87,6 +91,31 @@ report_mouse_t mouse_report_blank = {0};
 uint8_t extra_report_blank[3] = {0};
 #endif /* EXTRAKEY_ENABLE */
 
+/* Keyboard reports waiting for their IN transfer, the oldest one is being transmitted while in flight */
+#ifndef KEYBOARD_REPORT_QUEUE_SIZE
+#    define KEYBOARD_REPORT_QUEUE_SIZE 4
+#endif
+
+typedef struct {
+    report_keyboard_t report;
+    usbep_t           ep;
+    uint8_t           size;
+    bool              boot_protocol;
+} queued_keyboard_report_t;
+
+static queued_keyboard_report_t keyboard_report_queue[KEYBOARD_REPORT_QUEUE_SIZE];
+static uint8_t                  keyboard_report_queue_head      = 0;
+static uint8_t                  keyboard_report_queue_count     = 0;
+static bool                     keyboard_report_queue_in_flight = false;
+
+/* drop all queued reports
+ * called in locked state */
+static void keyboard_report_queue_clear_i(void) {
+    keyboard_report_queue_head      = 0;
+    keyboard_report_queue_count     = 0;
+    keyboard_report_queue_in_flight = false;
+}
+
 /* ---------------------------------------------------------
  *            Descriptors and USB driver objects
  * ---------------------------------------------------------
@@ -477,6 +506,10 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_CONFIGURED:
             osalSysLockFromISR();
+            keyboard_report_queue_clear_i();
+#ifdef SOF_SYNC_ENABLE
+            sof_sync_reset();
+#endif
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
@@ -511,6 +544,13 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Falls into.*/
         case USB_EVENT_RESET:
             usb_event_queue_enqueue(event);
+            /* The reports in flight will not complete */
+            osalSysLockFromISR();
+            keyboard_report_queue_clear_i();
+#ifdef SOF_SYNC_ENABLE
+            sof_sync_reset();
+#endif
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -767,12 +807,48 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
  *                  Keyboard functions
  * ---------------------------------------------------------
  */
+static inline queued_keyboard_report_t *keyboard_report_queue_at(uint8_t index) {
+    index += keyboard_report_queue_head;
+    return &keyboard_report_queue[index < KEYBOARD_REPORT_QUEUE_SIZE ? index : index - KEYBOARD_REPORT_QUEUE_SIZE];
+}
+
+/* start transmitting the oldest queued report, unless its endpoint is busy
+ * called in locked state */
+static void keyboard_report_queue_start_i(USBDriver *usbp) {
+    if (keyboard_report_queue_in_flight || keyboard_report_queue_count == 0) {
+        return;
+    }
+
+    queued_keyboard_report_t *queued = keyboard_report_queue_at(0);
+    /* A thread waiting for the endpoint goes first, the next IN callback comes back here */
+    if (usbGetTransmitStatusI(usbp, queued->ep) || usbp->epc[queued->ep]->in_state->thread != NULL) {
+        return;
+    }
+
+    usbStartTransmitI(usbp, queued->ep, queued->boot_protocol ? &queued->report.mods : queued->report.raw, queued->size);
+    keyboard_report_queue_in_flight = true;
+}
+
+/* a transfer on a keyboard report endpoint has completed
+ * called in locked state */
+static void keyboard_report_queue_in_cb_i(USBDriver *usbp, usbep_t ep) {
+    if (keyboard_report_queue_in_flight && keyboard_report_queue_at(0)->ep == ep) {
+        keyboard_report_queue_head      = keyboard_report_queue_at(1) - keyboard_report_queue;
+        keyboard_report_queue_in_flight = false;
+        keyboard_report_queue_count--;
+#ifdef SOF_SYNC_ENABLE
+        sof_sync_keyboard_read();
+#endif
+    }
+    keyboard_report_queue_start_i(usbp);
+}
+
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    keyboard_report_queue_in_cb_i(usbp, ep);
+    osalSysUnlockFromISR();
 }
 #endif
 
@@ -781,6 +857,9 @@ void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
  *  so that this is not going to have to be checked every 1ms */
 void kbd_sof_cb(USBDriver *usbp) {
     (void)usbp;
+#ifdef SOF_SYNC_ENABLE
+    sof_sync_start_of_frame();
+#endif
 }
 
 /* Idle requests timer code
@@ -808,7 +887,7 @@ static void keyboard_idle_timer_cb(void *arg) {
     if (keyboard_idle && keyboard_protocol) {
 #endif /* NKRO_ENABLE */
         /* TODO: are we sure we want the KBD_ENDPOINT? */
-        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
+        if (keyboard_report_queue_count == 0 && !usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
             usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)&keyboard_report_sent, KEYBOARD_EPSIZE);
         }
         /* rearm the timer */
@@ -825,7 +904,8 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-/* prepare and start sending a report IN
+/* queue a report and start sending it IN if the endpoint is free
+ * returns without waiting for the transfer, unless the queue is full
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
     osalSysLock();
@@ -833,53 +913,51 @@ void send_keyboard(report_keyboard_t *report) {
         goto unlock;
     }
 
+    queued_keyboard_report_t entry = {.report = *report};
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        entry.ep   = SHARED_IN_EPNUM;
+        entry.size = sizeof(struct nkro_report);
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        uint8_t *data, size;
+        entry.ep = KEYBOARD_IN_EPNUM;
         if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
+            entry.size = KEYBOARD_REPORT_SIZE;
         } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
+            entry.boot_protocol = true;
+            entry.size          = 8;
+        }
+    }
+
+    while (keyboard_report_queue_count == KEYBOARD_REPORT_QUEUE_SIZE) {
+        /* The newest report can take the place of the last queued one, if no press or release is lost by doing so.
+         * The oldest one may already be in flight, so it is never replaced. */
+        if (keyboard_report_queue_count > 1) {
+            queued_keyboard_report_t *previous = keyboard_report_queue_at(keyboard_report_queue_count - 2);
+            queued_keyboard_report_t *last     = keyboard_report_queue_at(keyboard_report_queue_count - 1);
+            if (last->ep == entry.ep && last->boot_protocol == entry.boot_protocol && can_replace_keyboard_report(&previous->report, &last->report, report)) {
+                *last = entry;
+                goto sent;
+            }
+        }
+
+        /* Otherwise wait until the oldest report has made it through.
+         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
+        keyboard_report_queue_start_i(&USB_DRIVER);
+        osalThreadSuspendS(&(&USB_DRIVER)->epc[keyboard_report_queue_at(0)->ep]->in_state->thread);
+
+        /* after osalThreadSuspendS returns USB status might have changed */
+        if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            goto unlock;
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
     }
+
+    *keyboard_report_queue_at(keyboard_report_queue_count) = entry;
+    keyboard_report_queue_count++;
+
+sent:
+    keyboard_report_queue_start_i(&USB_DRIVER);
     keyboard_report_sent = *report;
 
 unlock:
@@ -935,9 +1013,10 @@ void send_mouse(report_mouse_t *report) {
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    /* Keyboard reports may use the shared endpoint, either for NKRO or with KEYBOARD_SHARED_EP */
+    osalSysLockFromISR();
+    keyboard_report_queue_in_cb_i(usbp, ep);
+    osalSysUnlockFromISR();
 }
 #endif
 
@@ -23,6 +23,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "debug.h"
 #include "digitizer.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+#ifdef SOF_SYNC_ENABLE
+#    include "sof_sync.h"
+#endif
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -78,7 +84,16 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
+#ifdef SOF_SYNC_ENABLE
+    // Traced once the report is handed over to the driver
+    sof_sync_send_keyboard(report);
+#else
     (*driver->send_keyboard)(report);
+#    ifdef LATENCY_TRACE_ENABLE
+    // Drivers may route the report elsewhere, such as to Bluetooth, it has been handed over either way
+    latency_trace_report_sent(report);
+#    endif
+#endif
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
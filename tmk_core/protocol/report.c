@@ -15,6 +15,7 @@
  */
 
 #include "report.h"
+#include "action_util.h"
 #include "host.h"
 #include "keycode_config.h"
 #include "debug.h"
@@ -31,37 +32,129 @@ static int8_t cb_tail  = 0;
 static int8_t cb_count = 0;
 #endif
 
-/** \brief has_anykey
+/* All the supported platforms are little endian, so the first byte of a word holds its lowest bits */
+
+/** \brief Finds the zero bytes of a word
  *
- * FIXME: Needs doc
+ * Returns a word with the top bit of each zero byte of `word` set, and all the other bits cleared
+ */
+static inline uint32_t zero_bytes(uint32_t word) {
+    return ~(((word & 0x7F7F7F7FUL) + 0x7F7F7F7FUL) | word | 0x7F7F7F7FUL);
+}
+
+_Static_assert(KEYBOARD_REPORT_KEYS == 6, "The 6KRO keys are read as a word and a half word");
+
+/** \brief Reads keys 0 to 3, or keys 4 and 5 of the 6KRO report as a word
+ */
+static inline uint32_t keys_word(report_keyboard_t* report, uint8_t i) {
+    uint32_t word = 0;
+    if (i) {
+        memcpy(&word, &report->keys[4], 2);
+    } else {
+        memcpy(&word, &report->keys[0], 4);
+    }
+    return word;
+}
+
+/** \brief Returns the index of the first 6KRO key that equals `code`, or KEYBOARD_REPORT_KEYS if there is none
+ */
+static inline uint8_t find_key_byte(report_keyboard_t* report, uint8_t code) {
+    const uint32_t pattern = code * 0x01010101UL;
+    uint32_t       match   = zero_bytes(keys_word(report, 0) ^ pattern);
+    if (match) {
+        return __builtin_ctzl(match) >> 3;
+    }
+    match = zero_bytes(keys_word(report, 1) ^ pattern) & 0x8080;
+    if (match) {
+        return 4 + (__builtin_ctzl(match) >> 3);
+    }
+    return KEYBOARD_REPORT_KEYS;
+}
+
+#ifdef NKRO_ENABLE
+#    define NKRO_WORDS ((KEYBOARD_REPORT_BITS + 3) / 4)
+
+_Static_assert(NKRO_WORDS <= 32, "The NKRO summary has one bit per word of the bitmap");
+
+/* The words of the NKRO bitmap of keyboard_report that have keys in them, one bit per word, so that has_anykey() and
+ * get_first_key() do not scan the bitmap. It is only up to date while nkro_summary_report is keyboard_report, which
+ * is only changed through the functions below. */
+static uint32_t           nkro_summary        = 0;
+static report_keyboard_t* nkro_summary_report = NULL;
+
+/** \brief Reads word `i` of the NKRO bitmap
+ */
+static inline uint32_t nkro_word(report_keyboard_t* report, uint8_t i) {
+    uint32_t word = 0;
+    if (i * 4 + 4 <= KEYBOARD_REPORT_BITS) {
+        memcpy(&word, &report->nkro.bits[i * 4], 4);
+    } else {
+        memcpy(&word, &report->nkro.bits[i * 4], KEYBOARD_REPORT_BITS % 4);
+    }
+    return word;
+}
+
+/** \brief Returns the words of the NKRO bitmap that have keys in them, one bit per word
+ */
+static uint32_t nkro_nonzero_words(report_keyboard_t* report) {
+    if (report == nkro_summary_report) {
+        return nkro_summary;
+    }
+
+    uint32_t nonzero = 0;
+    for (uint8_t i = 0; i < NKRO_WORDS; i++) {
+        if (nkro_word(report, i)) {
+            nonzero |= 1UL << i;
+        }
+    }
+    if (report == keyboard_report) {
+        nkro_summary        = nonzero;
+        nkro_summary_report = report;
+    }
+    return nonzero;
+}
+#endif
+
+/** \brief Stops the NKRO summary from being used once the keys of the report are changed without it
+ */
+static inline void nkro_summary_invalidate(report_keyboard_t* report) {
+#ifdef NKRO_ENABLE
+    if (report == nkro_summary_report) {
+        nkro_summary_report = NULL;
+    }
+#endif
+}
+
+/** \brief Checks if any key is pressed in the report
+ *
+ * Returns non-zero if any key is pressed, modifiers are not taken into account
  */
 uint8_t has_anykey(report_keyboard_t* keyboard_report) {
-    uint8_t  cnt = 0;
-    uint8_t* p   = keyboard_report->keys;
-    uint8_t  lp  = sizeof(keyboard_report->keys);
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        p  = keyboard_report->nkro.bits;
-        lp = sizeof(keyboard_report->nkro.bits);
+        return nkro_nonzero_words(keyboard_report) != 0;
     }
 #endif
-    while (lp--) {
-        if (*p++) cnt++;
-    }
-    return cnt;
+    return (keys_word(keyboard_report, 0) | keys_word(keyboard_report, 1)) != 0;
 }
 
 /** \brief get_first_key
  *
- * FIXME: Needs doc
+ * Returns the first key in the report, or KC_NO if there is none. With NKRO, this is the highest key of the first
+ * byte of the bitmap that has keys in it.
  */
 uint8_t get_first_key(report_keyboard_t* keyboard_report) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        uint8_t i = 0;
-        for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
-            ;
-        return i << 3 | biton(keyboard_report->nkro.bits[i]);
+        const uint32_t nonzero = nkro_nonzero_words(keyboard_report);
+        if (!nonzero) {
+            return KC_NO;
+        }
+        const uint8_t  i    = __builtin_ctzl(nonzero);
+        const uint32_t word = nkro_word(keyboard_report, i);
+        const uint8_t  byte = __builtin_ctzl(word) >> 3;
+        const uint8_t  bits = word >> (byte * 8);
+        return (i * 4 + byte) << 3 | ((sizeof(unsigned int) * 8 - 1) - __builtin_clz(bits));
     }
 #endif
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
@@ -96,12 +189,7 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
         }
     }
 #endif
-    for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == key) {
-            return true;
-        }
-    }
-    return false;
+    return find_key_byte(keyboard_report, key) < KEYBOARD_REPORT_KEYS;
 }
 
 /** \brief add key byte
@@ -109,6 +197,7 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
  * FIXME: Needs doc
  */
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    nkro_summary_invalidate(keyboard_report);
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
     int8_t i     = cb_head;
     int8_t empty = -1;
@@ -153,20 +242,12 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
     cb_tail                        = RO_INC(cb_tail);
     cb_count++;
 #else
-    int8_t i     = 0;
-    int8_t empty = -1;
-    for (; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            break;
-        }
-        if (empty == -1 && keyboard_report->keys[i] == 0) {
-            empty = i;
-        }
+    if (find_key_byte(keyboard_report, code) < KEYBOARD_REPORT_KEYS) {
+        return;
     }
-    if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
-        }
+    const uint8_t empty = find_key_byte(keyboard_report, 0);
+    if (empty < KEYBOARD_REPORT_KEYS) {
+        keyboard_report->keys[empty] = code;
     }
 #endif
 }
@@ -176,6 +257,7 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
  * FIXME: Needs doc
  */
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    nkro_summary_invalidate(keyboard_report);
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
     uint8_t i = cb_head;
     if (cb_count) {
@@ -202,9 +284,18 @@ void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
         } while (i != cb_tail);
     }
 #else
-    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            keyboard_report->keys[i] = 0;
+    const uint32_t pattern = code * 0x01010101UL;
+    for (uint8_t i = 0; i < 2; i++) {
+        const uint32_t keys  = keys_word(keyboard_report, i);
+        const uint32_t match = zero_bytes(keys ^ pattern);
+        if (match) {
+            // Clears every matching byte at once, the bytes past the keys are not written back
+            const uint32_t cleared = keys & ~((match >> 7) * 0xFF);
+            if (i) {
+                memcpy(&keyboard_report->keys[4], &cleared, 2);
+            } else {
+                memcpy(&keyboard_report->keys[0], &cleared, 4);
+            }
         }
     }
 #endif
@@ -218,6 +309,9 @@ void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
 void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
         keyboard_report->nkro.bits[code >> 3] |= 1 << (code & 7);
+        if (keyboard_report == nkro_summary_report) {
+            nkro_summary |= 1UL << (code >> 5);
+        }
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
     }
@@ -230,6 +324,9 @@ void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
 void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
         keyboard_report->nkro.bits[code >> 3] &= ~(1 << (code & 7));
+        if (keyboard_report == nkro_summary_report && !nkro_word(keyboard_report, code >> 5)) {
+            nkro_summary &= ~(1UL << (code >> 5));
+        }
     } else {
         dprintf("del_key_bit: can't del: %02X\n", code);
     }
@@ -273,12 +370,64 @@ void clear_keys_from_report(report_keyboard_t* keyboard_report) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
         memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
+        if (keyboard_report == nkro_summary_report) {
+            nkro_summary = 0;
+        }
         return;
     }
 #endif
+    nkro_summary_invalidate(keyboard_report);
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
 }
 
+/** \brief Checks if a queued report can be replaced by the next one
+ *
+ * Returns true if sending `next` in place of `queued` keeps every change that `queued` makes to `previous`, and
+ * keeps them in order. This is the case unless `next` undoes one of these changes, or `queued` presses a key and
+ * `next` presses another key or changes the modifiers, as the host would then see both at once.
+ */
+bool can_replace_keyboard_report(report_keyboard_t* previous, report_keyboard_t* queued, report_keyboard_t* next) {
+    if ((previous->mods ^ queued->mods) & (queued->mods ^ next->mods)) {
+        return false;
+    }
+
+    bool queued_presses = false;
+    bool next_presses   = false;
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < NKRO_WORDS; i++) {
+            const uint32_t previous_bits = nkro_word(previous, i);
+            const uint32_t queued_bits   = nkro_word(queued, i);
+            const uint32_t next_bits     = nkro_word(next, i);
+            if ((previous_bits ^ queued_bits) & (queued_bits ^ next_bits)) {
+                return false;
+            }
+            queued_presses |= (queued_bits & ~previous_bits) != 0;
+            next_presses |= (next_bits & ~queued_bits) != 0;
+        }
+    } else
+#endif
+    {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            const uint8_t released = previous->keys[i];
+            if (released && !is_key_pressed(queued, released) && is_key_pressed(next, released)) {
+                return false;
+            }
+            const uint8_t pressed = queued->keys[i];
+            if (pressed && !is_key_pressed(previous, pressed)) {
+                if (!is_key_pressed(next, pressed)) {
+                    return false;
+                }
+                queued_presses = true;
+            }
+            next_presses |= next->keys[i] && !is_key_pressed(queued, next->keys[i]);
+        }
+    }
+
+    // Modifier changes in the same report are applied before the keys
+    return !queued_presses || (!next_presses && next->mods == queued->mods);
+}
+
 #ifdef MOUSE_ENABLE
 /**
  * @brief Compares 2 mouse reports for difference and returns result